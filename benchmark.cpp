@@ -0,0 +1,103 @@
+/*
+   Copyright 2022, Ansel Blumers
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+/*
+ * Timings of the Gamma and Erlang samplers in density/sampling.h, in ns per
+ * variate, against std::gamma_distribution and a sum of k exponentials.
+ * Build with -DCMAKE_BUILD_TYPE=Release and run bin/benchmark.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "density/sampling.h"
+
+using namespace statanaly;
+
+namespace {
+
+constexpr std::size_t N = 1 << 20;
+volatile double sink;
+
+template<class F>
+double nsPerVariate(F&& f) {
+    f();  // warm-up
+    const auto t0 = std::chrono::steady_clock::now();
+    f();
+    const auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / N;
+}
+
+void gammaRow(std::mt19937_64& eng, const double alpha) {
+    rngRef rng(eng);
+    std::vector<double> r(N);
+    const double ref = nsPerVariate([&]{
+        std::gamma_distribution<double> g(alpha);
+        double s = 0;
+        for (std::size_t i = 0; i < N; ++i) {s += g(eng);}
+        sink = s;
+    });
+    const double scalar = nsPerVariate([&]{
+        double s = 0;
+        for (std::size_t i = 0; i < N; ++i) {s += stdGamma(rng, alpha);}
+        sink = s;
+    });
+    const double batch = nsPerVariate([&]{
+        stdGamma(rng, alpha, r);
+        sink = r[N-1];
+    });
+    std::printf("Gamma(%-4g)  %8.1f %8.1f %8.1f\n", alpha, ref, scalar, batch);
+}
+
+void erlangRow(std::mt19937_64& eng, const unsigned k) {
+    rngRef rng(eng);
+    std::vector<double> r(N), e(N);
+    const double sum = nsPerVariate([&]{
+        std::fill(r.begin(), r.end(), 0.);
+        for (unsigned j = 0; j < k; ++j) {
+            stdExponential(rng, e);
+            for (std::size_t i = 0; i < N; ++i) {r[i] += e[i];}
+        }
+        sink = r[N-1];
+    });
+    const double scalar = nsPerVariate([&]{
+        double s = 0;
+        for (std::size_t i = 0; i < N; ++i) {s += stdErlang(rng, k);}
+        sink = s;
+    });
+    const double batch = nsPerVariate([&]{
+        stdErlang(rng, k, r);
+        sink = r[N-1];
+    });
+    std::printf("Erlang(%-3u)  %8.1f %8.1f %8.1f\n", k, sum, scalar, batch);
+}
+
+}
+
+int main() {
+    std::mt19937_64 eng(20221017);
+
+    std::printf("ns per variate, mt19937_64 behind rngRef, erlangProductMaxK = %u\n\n",
+                erlangProductMaxK);
+    std::printf("             std::gamma   scalar    batch\n");
+    for (const double alpha : {0.5, 3., 30.}) {gammaRow(eng, alpha);}
+
+    std::printf("\n             sum of exp   scalar    batch\n");
+    for (const unsigned k : {2u, 3u, 5u, 12u, 20u}) {erlangRow(eng, k);}
+    return 0;
+}
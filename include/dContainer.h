@@ -16,13 +16,85 @@
 #ifndef STATANALY_D_CONTAINER_H_
 #define STATANALY_D_CONTAINER_H_
 
+#include <memory_resource>
 #include <unordered_map>
 #include <vector>
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <ranges>
+#include <typeinfo>
 #include "density/probDistr.h"
 
 
 namespace statanaly {
 
+/** Components of a dCtr and their (unnormalized, normalized) weights. */
+using dIngredients = std::pmr::unordered_map<probDistr*, std::pair<double,double>>;
+
+
+/**
+ * @brief Walker's alias table over the normalized weights of a container.
+ * 
+ * Built by Vose's method in O(K). pick() maps one random word to a
+ * component in O(1): the high half of w*K is the column, the low half is
+ * the uniform that chooses between the column and its alias.
+ */
+struct dAliasTable {
+    std::vector<const probDistr*> comp;
+    std::vector<double> prob;
+    std::vector<std::uint32_t> alias;
+
+    explicit dAliasTable(const dIngredients& ingreds);
+
+    /** Index into comp. */
+    std::size_t pick(const std::uint64_t w) const noexcept {
+        const unsigned __int128 p = static_cast<unsigned __int128>(w) * comp.size();
+        const std::size_t i = static_cast<std::size_t>(p >> 64);
+        return toUnit(static_cast<std::uint64_t>(p)) < prob[i] ? i : alias[i];
+    }
+};
+
+
+/**
+ * @brief The components of a container grouped by type, with the parameters
+ * and normalized weights of each group in contiguous arrays.
+ * 
+ * Normal and Uniform components (the standard one included) are evaluated
+ * from their parameter arrays, one loop per group and no virtual calls; the
+ * Normal loops run on vecExp and vecErfc. Components of any other type go
+ * through their own pdf/cdf/sf.
+ * 
+ * A single x runs over the components in blocks; a batch runs over blocks
+ * of x, one component at a time.
+ */
+struct dGroups {
+    struct normalGroup {
+        std::vector<double> mu, invSig, logNorm, w;
+    };
+    struct uniformGroup {
+        std::vector<double> lo, hi, invWidth, w;
+    };
+
+    normalGroup normal;
+    uniformGroup uniform;
+    std::vector<const probDistr*> other;
+    std::vector<double> otherW;
+
+    explicit dGroups(const dIngredients& ingreds);
+
+    /** sum_i w_i * pdf_i(x), and likewise for cdf and sf. */
+    double pdf(const double x) const;
+    double cdf(const double x) const;
+    double sf(const double x) const;
+
+    void pdf(std::span<const double> x, std::span<double> r) const;
+    void cdf(std::span<const double> x, std::span<double> r) const;
+    void sf(std::span<const double> x, std::span<double> r) const;
+};
+
+
 /**
  * @brief Container class storing a collection of distributions.
  * 
@@ -38,11 +110,29 @@ namespace statanaly {
  * 
  *      {(Uniform, weight=1/3) (Normal, weight=1/3) (Normal, weight=1/3)}
  * 
+ * Inserted with merge, an equal component instead adds to the weight of
+ * the one already there:
+ * 
+ *      {(Uniform, weight=1/3) (Normal, weight=2/3)}
+ * 
+ * Components are indexed by their hash, computed once at insertion, so
+ * find() and merging are O(1).
+ * 
+ * A container made with an allocator keeps its components and both
+ * tables in that allocator's memory resource; an arena then serves every
+ * allocation. Copies are made in the default resource unless one is given.
+ * 
  * @param ingreds A collection of distribution and their weights.
  * @see disMixture
  */
 class dCtr {
     using weightType = double;
+
+public:
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+
+private:
+    allocator_type alloc;
     
     /**
      * @brief Internal storage for the collection.
@@ -50,43 +140,114 @@ class dCtr {
      * The first weight value is the unnormalized weight.
      * The second weight value is the normalized weight.
      */
-    std::unordered_map<probDistr*, std::pair<weightType,weightType>> ingreds;
+    dIngredients ingreds{alloc};
+
+    /**
+     * Components by their hash(). A multimap: without merging, equal
+     * components coexist. The index owns the components.
+     */
+    std::pmr::unordered_multimap<std::size_t, pmrPtr> index{alloc};
+
+    // Alias table and type groups of the normalized weights, built on
+    // first use and dropped whenever the weights change.
+    mutable std::atomic<std::shared_ptr<const dAliasTable>> aliasCache;
+    mutable std::atomic<std::shared_ptr<const dGroups>> groupCache;
+
+    void invalidate() {
+        aliasCache.store(nullptr);
+        groupCache.store(nullptr);
+    }
+
+    /** A component equal to distr -- same type and parameters -- or nullptr. */
+    template<typename F>
+    probDistr* lookup(const F& distr, const std::size_t h) const {
+        const auto [b, e] = index.equal_range(h);
+        for (auto it = b; it != e; ++it) {
+            // Equal hashes almost always mean equal components; confirm.
+            // isEqual_ulp casts to its own type, so compare the types first.
+            if (typeid(*it->second) == typeid(distr) && it->second->isEqual_ulp(distr, 0)) return it->second.get();
+        }
+        return nullptr;
+    }
+
+    /** insert() without the rescaling. */
+    template<typename F>
+    void place(const F& distr, const weightType weight, const bool merge) {
+        const std::size_t h = distr.hash();
+        if (merge) {
+            if (probDistr* d = lookup(distr, h)) {
+                ingreds.at(d).first += weight;
+                return;
+            }
+        }
+
+        // Make a deep-copy
+        auto it = index.emplace( h, distr.clone(alloc.resource()) );
+        ingreds.emplace( it->second.get(), std::make_pair(weight, weightType(0)) );
+    }
+
+    /** A component, given by reference or by (smart) pointer. */
+    template<typename T>
+    static const auto& component(const T& c) {
+        if constexpr (requires { *c; }) return *c;
+        else return c;
+    }
 
 public:
 
     dCtr() = default;
-    ~dCtr() {
-        for (auto& [d,ws] : ingreds) {delete d;}
-    };
+
+    /** An empty container in a's memory resource. */
+    explicit dCtr(const allocator_type& a) : alloc(a) {}
+
+    /** Build from (distribution, weight) pairs at once; see insertMany(). */
+    template<std::ranges::range R>
+    explicit dCtr(R&& items, const bool merge=false, const allocator_type& a={}) : alloc(a) {
+        insertMany(std::forward<R>(items), merge);
+    }
 
     /** Copy constructor: deep-copy, do the same as clone(). */
-    dCtr(const dCtr& o) {
-        // clone the named distribution.
-        for (const auto& [d,w] : o.ingreds) {
-            ingreds.emplace( d->clone(), w );
+    dCtr(const dCtr& o) : dCtr(o, allocator_type{}) {}
+
+    /** Deep-copy into a's memory resource. */
+    dCtr(const dCtr& o, const allocator_type& a) : alloc(a) {
+        ingreds.reserve(o.ingreds.size());
+        index.reserve(o.index.size());
+        // clone the named distribution; the clones keep the hashes.
+        for (const auto& [h,d] : o.index) {
+            auto it = index.emplace( h, d->clone(alloc.resource()) );
+            ingreds.emplace( it->second.get(), o.ingreds.at(d.get()) );
         }
     }
 
-    /** Copy assignment: deep-copy */
+    /** Copy assignment: deep-copy, into this container's memory resource. */
     dCtr& operator = (const dCtr& o) {
-        // clone the named distribution.
-        for (const auto& [d,w] : o.ingreds) {
-            ingreds.emplace( d->clone(), w );
+        if (this != &o) {
+            dCtr tmp(o, alloc);
+            *this = std::move(tmp);
         }
         return *this;
     };
     
-    /** Move constructor */
-    dCtr(dCtr&& o) {
-        std::swap(ingreds, o.ingreds);
+    /** Move constructor: takes over o's memory resource. */
+    dCtr(dCtr&& o) : alloc(o.alloc) {
+        ingreds.swap(o.ingreds);
+        index.swap(o.index);
+        o.invalidate();
     }
 
-    /** Move assignment */
+    /** Move assignment; copies when o lives in another memory resource. */
     dCtr& operator = (dCtr&& o) {
-        std::swap(ingreds, o.ingreds);
+        if (alloc != o.alloc) return *this = static_cast<const dCtr&>(o);
+        ingreds.swap(o.ingreds);
+        index.swap(o.index);
+        invalidate();
+        o.invalidate();
         return *this;
     }
 
+    allocator_type get_allocator() const noexcept {return alloc;}
+
     std::unique_ptr<dCtr> cloneUnique() const {
         return std::make_unique<dCtr>(static_cast<dCtr const&>(*this));
     };
@@ -97,22 +258,46 @@ public:
 
     /** Rescale weight distribution after named distribution insertion and deletion. */
     void rescale() {
+        invalidate();
         weightType sum = 0;
         for (const auto& [d,ws] : ingreds) {sum += ws.first;}
         for (auto& [d,ws] : ingreds) {ws.second = (ws.first) / sum;}
     }
 
-    /** Insert a distribution and its weight */
+    /**
+     * @brief Insert a distribution and its weight
+     * 
+     * @param merge If an equal component is already in: add weight to its
+     * weight instead of inserting another copy.
+     */
     template<typename F, typename W>
     requires std::is_arithmetic_v<W>
-    void insert(F&& distr, W weight) {
-        // Make a deep-copy
-        auto tmp = std::make_pair<weightType,weightType>(static_cast<weightType>(weight), 0);
-        ingreds.emplace( distr.clone(), tmp );
+    void insert(F&& distr, W weight, const bool merge=false) {
+        place(distr, static_cast<weightType>(weight), merge);
 
         // Rescale the weights so that they sum up to one.
         rescale();
     }
+
+    /**
+     * @brief Insert many (distribution, weight) pairs.
+     * 
+     * The same as inserting them one by one, but the storage grows once and
+     * the weights are rescaled once: O(K) rather than O(K^2) for K pairs.
+     * The distribution in a pair may be an object or a (smart) pointer to one.
+     */
+    template<std::ranges::range R>
+    void insertMany(R&& items, const bool merge=false) {
+        if constexpr (std::ranges::sized_range<R>) {
+            const std::size_t n = ingreds.size() + std::ranges::size(items);
+            ingreds.reserve(n);
+            index.reserve(n);
+        }
+        for (const auto& [distr, weight] : items) {
+            place(component(distr), static_cast<weightType>(weight), merge);
+        }
+        rescale();
+    }
     
     /** Insert a distribution and set its weight to one. */
     template<typename F>
@@ -121,18 +306,75 @@ public:
         insert( std::forward<F>(distr), 1);
     }
 
-    /** Find a distribution that match another distribution's hash (ie, type and parameters). */
+    /** Find a distribution equal to another one (ie, type and parameters). O(1). */
     template<typename F>
     inline auto find(F&& distr) const {
-        for (auto it = ingreds.begin(); it != ingreds.end(); it++) {
-            if (it->first->hash() == distr.hash()) {return it;}
-        }
-        return ingreds.end();
+        probDistr* d = lookup(distr, distr.hash());
+        return d ? ingreds.find(d) : ingreds.end();
     }
 
     inline const auto& get() const {return ingreds;}
     inline const auto end() const {return ingreds.end();}
-    inline void clear() {ingreds.clear();}
+    inline void clear() {
+        invalidate();
+        ingreds.clear();
+        index.clear();
+    }
+
+    /**
+     * @brief Merge normal components, cheapest first, until at most
+     * maxComponents components are left or the next merge would cost more
+     * than maxCost.
+     * 
+     * A merge replaces two normals by one of the same weight, mean and
+     * variance, so the moments of the container are unchanged. Its cost is
+     * Runnalls' bound on the Kullback-Leibler discrepancy it adds,
+     * 
+     *      B(i,j) = ((wi+wj) log(v) - wi log(vi) - wj log(vj)) / 2
+     * 
+     * with normalized weights w and v the variance of the merged normal.
+     * 
+     * Candidates sit in a priority queue. Each normal queues its cheapest
+     * partner among the reduceWindow nearest on either side in order of
+     * mean -- in 1D those hold the cheap merges -- and looks again once that
+     * partner is merged away. The other components are left as they are.
+     * 
+     * @return The summed cost of the merges made.
+     */
+    double reduce(const std::size_t maxComponents,
+                  const double maxCost = std::numeric_limits<double>::infinity());
+
+    /** How far apart, in order of mean, the candidates of reduce() may be. */
+    static constexpr std::size_t reduceWindow = 8;
+
+    /**
+     * @brief Alias table of the normalized weights, for O(1) sampling.
+     * 
+     * Built on the first call after a change to the weights. Concurrent
+     * readers may build it at the same time; they all get an equal table.
+     */
+    std::shared_ptr<const dAliasTable> aliasTable() const {
+        auto t = aliasCache.load();
+        if (!t) {
+            t = std::make_shared<const dAliasTable>(ingreds);
+            aliasCache.store(t);
+        }
+        return t;
+    }
+
+    /**
+     * @brief The components grouped by type, for disMixture's pdf, cdf and sf.
+     * 
+     * Built and dropped like aliasTable().
+     */
+    std::shared_ptr<const dGroups> groups() const {
+        auto g = groupCache.load();
+        if (!g) {
+            g = std::make_shared<const dGroups>(ingreds);
+            groupCache.store(g);
+        }
+        return g;
+    }
 
     /**
      * @brief Computing the hash of this class instance.
@@ -30,6 +30,8 @@
 #include "density/disChiSq.h"
 #include "density/disNcChi.h"
 #include "density/disNcChiSq.h"
+#include "density/disEmpirical.h"
+#include <cstdint>
 
 
 /**
@@ -40,22 +42,72 @@
  * 
  * 1. Callback functions for double dispatcher when convoluting two distributions.
  * 2. Functions for convoluting a collection of distribution of the same type. 
+ * 3. A Monte Carlo fallback for pairs without a closed form.
  * 
  * Because the argument types are concrete types, one can call 
  * those functions with concrete types directly.
  *
+ * Results are made by new, for the caller to delete; under an arenaScope,
+ * in the calling thread's distrArena instead, for its release().
+ *
  * Remember: Sum of two or more Independent Random Variables is 
  * the Convolution of their individual distributions. 
  */
 
 namespace statanaly {
 
+class parallelSampler;
+
 // Create a Double Dispatcher for Convolution.
 extern FnDispatcher<probDistr,probDistr,probDistr*> cnvl;
 extern FnDispatcher<probDistr,probDistr,probDistr*> cnvlSq;
 extern FnDispatcher<probDistr,probDistr,probDistr*> cnvlSSqrt;
 
 
+/**
+ * @brief Settings of the Monte Carlo convolutions.
+ */
+struct mcOptions {
+    std::size_t samples = 1<<20;    // sample budget
+    std::uint64_t seed = 0;         // key of the rng_philox streams
+    unsigned threads = 0;           // 0 for std::thread::hardware_concurrency()
+    parallelSampler* sampler = nullptr; // caller-owned; overrides threads
+};
+
+/**
+ * @brief Monte Carlo R = X + Y, for any pair.
+ * 
+ * X and Y are drawn by opt.sampler, or else by a pool of opt.threads
+ * threads kept for all calls, as jobs 0 and 1 under key opt.seed; the
+ * result depends on opt.seed and opt.samples only.
+ * disEmpirical::stdError() reports the standard error of its mean.
+ */
+disEmpirical* convolveMC(const probDistr& lhs, const probDistr& rhs, const mcOptions& opt = {});
+
+/**
+ * @brief Monte Carlo R = X^2 + Y^2, for any pair.
+ * @see convolveMC
+ */
+disEmpirical* convolveSqMC(const probDistr& lhs, const probDistr& rhs, const mcOptions& opt = {});
+
+/**
+ * @brief Monte Carlo R = sqrt(X^2 + Y^2), for any pair.
+ * @see convolveMC
+ */
+disEmpirical* convolveSSqrtMC(const probDistr& lhs, const probDistr& rhs, const mcOptions& opt = {});
+
+/**
+ * @brief Resolve the pairs cnvl, cnvlSq and cnvlSSqrt have no rule for by
+ * convolveMC, convolveSqMC and convolveSSqrtMC, instead of throwing.
+ * 
+ * Off by default: a closed form is exact, a Monte Carlo result is not.
+ */
+void enableMonteCarloFallback(const mcOptions& opt = {});
+
+/** Restore the "Function not found" error for unregistered pairs. */
+void disableMonteCarloFallback();
+
+
 /**
  * @brief Sum of two Standard Uniform RVs.
  * 
@@ -33,24 +33,108 @@ private:
     double t;
     double s;
 
+    // Derived from the parameters once, at construction.
+    double invS;        // 1/s
+    double invSPi;      // 1/(s*pi)
+    double logInvSPi;   // log(invSPi)
+
+    /** P(Z > z) of the standard Cauchy, accurate in the upper tail. */
+    static double upperTail(const double z) {
+        return z > 0 ? atan(1/z)*M_1_PIf64 : 0.5 - atan(z)*M_1_PIf64;
+    }
+
 public:
     template<class T>
     requires std::is_arithmetic_v<T>
     disCauchy(const T loc, const T scale) {
         t = loc;
         s = scale;
+        invS = 1/s;
+        invSPi = M_1_PIf64/s;
+        logInvSPi = log(invSPi);
     }
     disCauchy() = delete;
 
     double pdf(const double x) const override {
-        const double scaledx = (x-t)/s;
-        const double tmp = s*M_PIf64*(1.0+scaledx*scaledx);
-        return 1.0/tmp;
+        const double scaledx = (x-t)*invS;
+        return invSPi/(1.0+scaledx*scaledx);
     }
 
     double cdf(const double x) const override {
-        const double scaledx = (x-t)/s;
-        return 0.5 + atan(scaledx)*M_1_PIf64;
+        return upperTail((t-x)*invS);
+    }
+
+    void pdf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disCauchy::pdf(v); });
+    }
+
+    void cdf(std::span<const double> x, std::span<double> r) const override {
+        batchEvalBlock(x, r, [this](std::span<const double> xs, std::span<double> b){
+            // upperTail((t-x)/s), with one vecAtan for the block.
+            for (std::size_t i=0; i<b.size(); ++i) {
+                const double z = (t-xs[i])*invS;
+                b[i] = z > 0 ? 1/z : z;
+            }
+            vecAtan(b, b);
+            for (std::size_t i=0; i<b.size(); ++i) {
+                b[i] = (t-xs[i])*invS > 0 ? b[i]*M_1_PIf64 : 0.5 - b[i]*M_1_PIf64;
+            }
+        });
+    }
+
+    double logpdf(const double x) const override {
+        const double scaledx = (x-t)*invS;
+        return logInvSPi - std::log1p(scaledx*scaledx);
+    }
+
+    double logcdf(const double x) const override {
+        return log(upperTail((t-x)*invS));
+    }
+
+    double sf(const double x) const override {
+        return upperTail((x-t)*invS);
+    }
+
+    double logsf(const double x) const override {
+        return log(upperTail((x-t)*invS));
+    }
+
+    void logpdf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disCauchy::logpdf(v); });
+    }
+
+    void logcdf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disCauchy::logcdf(v); });
+    }
+
+    void sf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disCauchy::sf(v); });
+    }
+
+    void logsf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disCauchy::logsf(v); });
+    }
+
+    double quantile(const double p) const override {
+        checkProbability(p);
+        // tan(pi*(p-1/2)), written to keep relative accuracy in both tails.
+        if (p < 0.5) return t - s/tan(M_PIf64*p);
+        return t + s/tan(M_PIf64*(1-p));
+    }
+
+    void quantile(std::span<const double> p, std::span<double> r) const override {
+        batchEval(p, r, [this](const double v){ return disCauchy::quantile(v); });
+    }
+
+    /** Inverse transform. */
+    double draw(rngRef rng) const override {
+        return t + s*tan(M_PIf64*(toOpenUnit(rng()) - 0.5));
+    }
+
+    void draw(rngRef rng, std::span<double> r) const override {
+        sampleBlock(rng, r, [this](std::span<const std::uint64_t> w, std::span<double> v){
+            for (std::size_t i=0; i<v.size(); ++i) {v[i] = t + s*tan(M_PIf64*(toOpenUnit(w[i]) - 0.5));}
+        });
     }
 
     double mean() const override {
@@ -92,6 +176,10 @@ public:
         return new disCauchy(*this);
     }
 
+    pmrPtr clone(std::pmr::memory_resource* mr) const override {
+        return pmrClone(*this, mr);
+    }
+
     void print(std::ostream& output) const override {
         output << "Cauchy distribution -- s = " << s << "  t = " << t;
     }
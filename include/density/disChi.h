@@ -31,21 +31,105 @@ private:
 
     unsigned k;
 
+    // Derived from the parameters once, at construction.
+    double norm;        // 1/(2^(k/2-1) * Gamma(k/2))
+    double logNorm;     // log(norm)
+
 public:
     template<class T>
     requires std::is_integral_v<T>
     disChi(const T dof) {
         k = dof;
+        logNorm = -(k/2.-1)*M_LN2 - std::lgamma(k/2.);
+        norm = exp(logNorm);
     }
     ~disChi() = default;
 
     double pdf(const double x) const override {
-        const double ko2 = pow(2,k/2.-1) * std::tgamma(k/2.);
-        return pow(x,k-1) * exp(-x*x/2) / ko2;
+        return pow(x,k-1) * exp(-x*x/2) * norm;
     }
 
     double cdf(const double x) const override {
-        return regLowerGamma(k/2.0, x*x/2);
+        return regLowerGamma(k/2.0, x < 0 ? 0 : x*x/2);
+    }
+
+    void pdf(std::span<const double> x, std::span<double> r) const override {
+        // Log-space: (k-1)*log(x) - x^2/2 + logNorm.
+        batchEvalBlock(x, r, [this](std::span<const double> xs, std::span<double> b){
+            vecLog(xs, b);
+            for (std::size_t i=0; i<b.size(); ++i) {b[i] = (k-1.)*b[i] - 0.5*xs[i]*xs[i] + logNorm;}
+            vecExp(b, b);
+            for (std::size_t i=0; i<b.size(); ++i) {
+                if (!(xs[i] > 0)) b[i] = disChi::pdf(xs[i]);
+            }
+        });
+    }
+
+    void cdf(std::span<const double> x, std::span<double> r) const override {
+        batchEvalBlock(x, r, [this](std::span<const double> xs, std::span<double> b){
+            for (std::size_t i=0; i<b.size(); ++i) {b[i] = xs[i] < 0 ? 0 : 0.5*xs[i]*xs[i];}
+            regLowerGamma(k*0.5, b, b);
+        });
+    }
+
+    double logpdf(const double x) const override {
+        if (!(x > 0)) return log(pdf(x));
+        return (k-1.)*log(x) - 0.5*x*x + logNorm;
+    }
+
+    double logcdf(const double x) const override {
+        return log(cdf(x));
+    }
+
+    double sf(const double x) const override {
+        return regUpperGamma(k/2.0, x < 0 ? 0 : x*x/2);
+    }
+
+    double logsf(const double x) const override {
+        return log(sf(x));
+    }
+
+    void logpdf(std::span<const double> x, std::span<double> r) const override {
+        batchEvalBlock(x, r, [this](std::span<const double> xs, std::span<double> b){
+            vecLog(xs, b);
+            for (std::size_t i=0; i<b.size(); ++i) {
+                b[i] = xs[i] > 0 ? (k-1.)*b[i] - 0.5*xs[i]*xs[i] + logNorm : disChi::logpdf(xs[i]);
+            }
+        });
+    }
+
+    void logcdf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disChi::logcdf(v); });
+    }
+
+    void sf(std::span<const double> x, std::span<double> r) const override {
+        batchEvalBlock(x, r, [this](std::span<const double> xs, std::span<double> b){
+            for (std::size_t i=0; i<b.size(); ++i) {b[i] = xs[i] < 0 ? 0 : 0.5*xs[i]*xs[i];}
+            regUpperGamma(k*0.5, b, b);
+        });
+    }
+
+    void logsf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disChi::logsf(v); });
+    }
+
+    double quantile(const double p) const override {
+        checkProbability(p);
+        return std::sqrt(2*invRegLowerGamma(k/2.0, p));
+    }
+
+    void quantile(std::span<const double> p, std::span<double> r) const override {
+        batchEval(p, r, [this](const double v){ return disChi::quantile(v); });
+    }
+
+    /** Square root of a chi-squared variate. */
+    double draw(rngRef rng) const override {
+        return std::sqrt(stdChiSq(rng, k));
+    }
+
+    void draw(rngRef rng, std::span<double> r) const override {
+        stdChiSq(rng, k, r);
+        for (auto& v : r) {v = std::sqrt(v);}
     }
 
     double mean() const override {
@@ -82,6 +166,10 @@ public:
         return new disChi(*this);
     }
 
+    pmrPtr clone(std::pmr::memory_resource* mr) const override {
+        return pmrClone(*this, mr);
+    }
+
     void print(std::ostream& output) const override {
         output << "Central Chi distribution -- k = " << k;
     }
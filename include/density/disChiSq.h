@@ -31,24 +31,100 @@ class disChiSq : public probDistr {
 private:
     unsigned k;
 
+    // Derived from the parameters once, at construction.
+    double logNorm;     // -(k/2)*log(2) - log(Gamma(k/2))
+
 public:
     template<class T> 
     requires std::is_integral_v<T>
     disChiSq(const T dof){
         k = dof;
+        logNorm = -(k*0.5)*M_LN2 - logGamma(k*0.5);
     }
     ~disChiSq() = default;
 
     double pdf(const double x) const override {
-        const double kd2 = k*0.5;
-        const double lgf = logGamma(kd2);
-        const double r   = exp((kd2-1.0)*log(x) - x*0.5 - kd2*M_LN2 - lgf);
-        return r;
+        return exp((k*0.5-1.0)*log(x) - x*0.5 + logNorm);
     }
 
     double cdf(const double x) const override {
-        const double lgf = regLowerGamma(k/2.0, x/2.0);
-        return lgf;
+        return regLowerGamma(k/2.0, x/2.0);
+    }
+
+    void pdf(std::span<const double> x, std::span<double> r) const override {
+        batchEvalBlock(x, r, [this](std::span<const double> xs, std::span<double> b){
+            vecLog(xs, b);
+            for (std::size_t i=0; i<b.size(); ++i) {b[i] = (k*0.5-1.)*b[i] - 0.5*xs[i] + logNorm;}
+            vecExp(b, b);
+            for (std::size_t i=0; i<b.size(); ++i) {
+                if (!(xs[i] > 0)) b[i] = disChiSq::pdf(xs[i]);
+            }
+        });
+    }
+
+    void cdf(std::span<const double> x, std::span<double> r) const override {
+        batchEvalBlock(x, r, [this](std::span<const double> xs, std::span<double> b){
+            for (std::size_t i=0; i<b.size(); ++i) {b[i] = 0.5*xs[i];}
+            regLowerGamma(k*0.5, b, b);
+        });
+    }
+
+    double logpdf(const double x) const override {
+        if (!(x > 0)) return log(pdf(x));
+        return (k*0.5-1.)*log(x) - 0.5*x + logNorm;
+    }
+
+    double logcdf(const double x) const override {
+        return log(cdf(x));
+    }
+
+    double sf(const double x) const override {
+        return regUpperGamma(k/2.0, x/2.0);
+    }
+
+    double logsf(const double x) const override {
+        return log(sf(x));
+    }
+
+    void logpdf(std::span<const double> x, std::span<double> r) const override {
+        batchEvalBlock(x, r, [this](std::span<const double> xs, std::span<double> b){
+            vecLog(xs, b);
+            for (std::size_t i=0; i<b.size(); ++i) {
+                b[i] = xs[i] > 0 ? (k*0.5-1.)*b[i] - 0.5*xs[i] + logNorm : disChiSq::logpdf(xs[i]);
+            }
+        });
+    }
+
+    void logcdf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disChiSq::logcdf(v); });
+    }
+
+    void sf(std::span<const double> x, std::span<double> r) const override {
+        batchEvalBlock(x, r, [this](std::span<const double> xs, std::span<double> b){
+            for (std::size_t i=0; i<b.size(); ++i) {b[i] = 0.5*xs[i];}
+            regUpperGamma(k*0.5, b, b);
+        });
+    }
+
+    void logsf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disChiSq::logsf(v); });
+    }
+
+    double quantile(const double p) const override {
+        checkProbability(p);
+        return 2*invRegLowerGamma(k/2.0, p);
+    }
+
+    void quantile(std::span<const double> p, std::span<double> r) const override {
+        batchEval(p, r, [this](const double v){ return disChiSq::quantile(v); });
+    }
+
+    double draw(rngRef rng) const override {
+        return stdChiSq(rng, k);
+    }
+
+    void draw(rngRef rng, std::span<double> r) const override {
+        stdChiSq(rng, k, r);
     }
 
     double mean() const override {
@@ -82,6 +158,10 @@ public:
         return new disChiSq(*this);
     }
 
+    pmrPtr clone(std::pmr::memory_resource* mr) const override {
+        return pmrClone(*this, mr);
+    }
+
     void print(std::ostream& output) const override {
         output << "Central Chi Square distribution -- k = " << k;
     }
@@ -0,0 +1,244 @@
+/*
+   Copyright 2022, Ansel Blumers
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef STATANALY_DIS_EMPIRICAL_H_
+#define STATANALY_DIS_EMPIRICAL_H_
+
+#include "probDistr.h"
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+
+namespace statanaly {
+
+
+/**
+ * @brief Empirical Distribution
+ *
+ * The distribution of a set of samples, eg. the result of a Monte Carlo
+ * simulation or telemetry. The samples are kept sorted and contiguous:
+ * cdf is the step function of the samples, by a binary search; quantile
+ * interpolates linearly between order statistics (type 7), in O(1).
+ *
+ * pdf is a density estimate, continuous in x. It is the slope of the
+ * interpolated cdf, the inverse of quantile, across a window with the
+ * variance of Silverman's normal reference kernel. That takes two binary
+ * searches per point, whatever the number of samples in the window.
+ *
+ * The moments and the hash are computed once, at construction. The samples are shared
+ * by copies and never written, so copying and cloning are O(1).
+ *
+ * From a file, the samples are memory mapped rather than read, so a file
+ * larger than memory still works; see save() for the format.
+ *
+ * @param samples At least one sample, none NaN.
+ */
+
+class disEmpirical : public probDistr {
+private:
+
+    std::shared_ptr<const void> store;  // owns the memory behind xs
+    std::span<const double> xs;         // sorted
+
+    // Derived from the samples once, at construction.
+    double mu;
+    double var;
+    double skew;
+    double halfWidth;   // of the pdf window
+    std::size_t sampleHash;
+
+    void build();
+
+    /** The interpolated cdf: the inverse of quantile(), continuous in x. */
+    double cdfLinear(const double x) const {
+        if (!(x > xs.front())) return 0;
+        if (!(x < xs.back())) return 1;
+        const std::size_t i = countLE(x);   // xs[i-1] <= x < xs[i]
+        return (i-1 + (x-xs[i-1]) / (xs[i]-xs[i-1])) / (xs.size()-1);
+    }
+
+    /** Number of samples <= x. */
+    std::size_t countLE(const double x) const {
+        return std::upper_bound(xs.begin(), xs.end(), x) - xs.begin();
+    }
+
+public:
+
+    explicit disEmpirical(std::vector<double> samples);
+
+    /**
+     * @brief Map the samples of a file written by save().
+     *
+     * @param sortInPlace If the file is not sorted: sort it, rewriting the
+     * file, when true; throw std::invalid_argument when false.
+     */
+    explicit disEmpirical(const std::filesystem::path& file, const bool sortInPlace=false);
+    disEmpirical() = delete;
+    ~disEmpirical() = default;
+
+    double pdf(const double x) const override {
+        if (std::isnan(x)) return x;
+        if (halfWidth == 0) return x == xs.front() ? INFINITY : 0;
+        return (cdfLinear(x+halfWidth) - cdfLinear(x-halfWidth)) / (2*halfWidth);
+    }
+
+    double cdf(const double x) const override {
+        if (std::isnan(x)) return x;
+        return double(countLE(x)) / xs.size();
+    }
+
+    double sf(const double x) const override {
+        if (std::isnan(x)) return x;
+        return double(xs.size() - countLE(x)) / xs.size();
+    }
+
+    void pdf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disEmpirical::pdf(v); });
+    }
+
+    void cdf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disEmpirical::cdf(v); });
+    }
+
+    void sf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disEmpirical::sf(v); });
+    }
+
+    /** Linear between the order statistics at (n-1)p. */
+    double quantile(const double p) const override {
+        checkProbability(p);
+        const double h = (xs.size()-1) * p;
+        const std::size_t i = std::min(std::size_t(h), xs.size()-1);
+        if (i+1 == xs.size()) return xs.back();
+        return xs[i] + (h-i)*(xs[i+1]-xs[i]);
+    }
+
+    void quantile(std::span<const double> p, std::span<double> r) const override {
+        batchEval(p, r, [this](const double v){ return disEmpirical::quantile(v); });
+    }
+
+    double draw(rngRef rng) const override {
+        return disEmpirical::quantile(toUnit(rng()));
+    }
+
+    void draw(rngRef rng, std::span<double> r) const override {
+        sampleBlock(rng, r, [this](std::span<const std::uint64_t> w, std::span<double> b){
+            for (std::size_t i=0; i<b.size(); ++i) {b[i] = disEmpirical::quantile(toUnit(w[i]));}
+        });
+    }
+
+    double mean() const override {
+        return mu;
+    }
+
+    double stddev() const override {
+        return std::sqrt(var);
+    }
+
+    double variance() const override {
+        return var;
+    }
+
+    double skewness() const override {
+        return skew;
+    }
+
+    /** Standard error of mean(). */
+    double stdError() const noexcept {
+        return std::sqrt(var / xs.size());
+    }
+
+    /** Standard error of cdf(x). */
+    double stdErrorCdf(const double x) const {
+        const double F = cdf(x);
+        return std::sqrt(F*(1-F) / xs.size());
+    }
+
+    std::size_t size() const noexcept {
+        return xs.size();
+    }
+
+    /** The samples, in ascending order. */
+    std::span<const double> samples() const noexcept {
+        return xs;
+    }
+
+    /** Write the samples, in order, as raw native-endian doubles. */
+    void save(const std::filesystem::path& file) const;
+
+    /** Of every sample, computed once at construction. */
+    inline std::size_t hash() const noexcept {
+        return sampleHash;
+    }
+
+    std::unique_ptr<probDistr> cloneUnique() const override {
+        return std::make_unique<disEmpirical>(static_cast<disEmpirical const&>(*this));
+    };
+
+    disEmpirical* clone() const override {
+        return new disEmpirical(*this);
+    }
+
+    pmrPtr clone(std::pmr::memory_resource* mr) const override {
+        return pmrClone(*this, mr);
+    }
+
+    void print(std::ostream& output) const override {
+        output << "Empirical distribution -- n = " << xs.size() << " mean = " << mu
+               << " stddev = " << std::sqrt(var);
+    }
+
+    bool isEqual_tol(const probDistr& o, const double tol) const override {
+        const disEmpirical& oo = dynamic_cast<const disEmpirical&>(o);
+        if (xs.size() != oo.xs.size()) return false;
+        for (std::size_t i=0; i<xs.size(); ++i) {
+            if (!isEqual_fl_tol(xs[i], oo.xs[i], tol)) return false;
+        }
+        return true;
+    }
+
+    bool isEqual_ulp(const probDistr& o, const unsigned ulp) const override {
+        const disEmpirical& oo = dynamic_cast<const disEmpirical&>(o);
+        if (xs.size() != oo.xs.size()) return false;
+        for (std::size_t i=0; i<xs.size(); ++i) {
+            if (!isEqual_fl_ulp(xs[i], oo.xs[i], ulp)) return false;
+        }
+        return true;
+    }
+
+    virtual dFuncID getID() const {return id;};
+    const dFuncID id = dFuncID::EMPIRICAL_DISTR;
+};
+
+}   // namespace statanaly
+
+
+/**
+ * @brief STL hasher overload
+ *
+ * @tparam Empirical distribution
+ */
+
+template<>
+class std::hash<statanaly::disEmpirical> {
+public:
+    std::size_t operator() (const statanaly::disEmpirical& d) const {
+        return d.hash();
+    }
+};
+
+#endif
@@ -33,23 +33,113 @@ private:
     unsigned k;
     double lambda;
 
+    // Derived from the parameters once, at construction.
+    double logNorm;     // log(lambda^k / (k-1)!)
+    double logSaddle;   // log(lambda) - stirlerr(k-1) - log(sqrt(2 pi (k-1))), for k >= 2
+
+    /** log pdf at x > 0. For k >= 2 in Loader's saddle point form, which
+     *  keeps its accuracy for shapes in the millions. */
+    double logDensity(const double x) const {
+        if (k < 2) return logNorm - lambda*x;
+        return logSaddle - bd0(k-1., lambda*x);
+    }
+
 public:
     template<typename T, typename P>
     requires std::is_integral_v<T> && std::is_arithmetic_v<P>
     disErlang(const T shape, const P rate) {
         k = shape;
         lambda = rate;
+        logNorm = k*log(lambda) - std::lgamma(double(k));
+        logSaddle = k >= 2 ? log(lambda) - stirlerr(k-1.) - 0.5*log(2*M_PI*(k-1.)) : 0;
     }
     disErlang() = delete;
 
 
     double pdf(const double x) const override {
-        double r = pow(lambda,k) / factorial[k-1] * pow(x,k-1) / exp(lambda*x);
-        return r;
+        if (x > 0) return exp(logDensity(x));
+        if (x == 0) return k == 1 ? lambda : 0;
+        return x < 0 ? 0 : x;
     }
 
     double cdf(const double x) const override {
-        return lowerGamma(k,lambda*x) / factorial[k-1];
+        return regLowerGamma(k, lambda*x);
+    }
+
+    void pdf(std::span<const double> x, std::span<double> r) const override {
+        batchEvalBlock(x, r, [this](std::span<const double> xs, std::span<double> b){
+            for (std::size_t i=0; i<b.size(); ++i) {b[i] = xs[i] > 0 ? logDensity(xs[i]) : 0;}
+            vecExp(b, b);
+            for (std::size_t i=0; i<b.size(); ++i) {
+                if (!(xs[i] > 0)) b[i] = disErlang::pdf(xs[i]);
+            }
+        });
+    }
+
+    void cdf(std::span<const double> x, std::span<double> r) const override {
+        batchEvalBlock(x, r, [this](std::span<const double> xs, std::span<double> b){
+            for (std::size_t i=0; i<b.size(); ++i) {b[i] = lambda*xs[i];}
+            regLowerGamma(k, b, b);
+        });
+    }
+
+    double logpdf(const double x) const override {
+        if (!(x > 0)) return log(pdf(x));
+        return logDensity(x);
+    }
+
+    double logcdf(const double x) const override {
+        return log(cdf(x));
+    }
+
+    double sf(const double x) const override {
+        return regUpperGamma(k, lambda*x);
+    }
+
+    double logsf(const double x) const override {
+        return log(sf(x));
+    }
+
+    void logpdf(std::span<const double> x, std::span<double> r) const override {
+        batchEvalBlock(x, r, [this](std::span<const double> xs, std::span<double> b){
+            for (std::size_t i=0; i<b.size(); ++i) {
+                b[i] = xs[i] > 0 ? logDensity(xs[i]) : disErlang::logpdf(xs[i]);
+            }
+        });
+    }
+
+    void logcdf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disErlang::logcdf(v); });
+    }
+
+    void sf(std::span<const double> x, std::span<double> r) const override {
+        batchEvalBlock(x, r, [this](std::span<const double> xs, std::span<double> b){
+            for (std::size_t i=0; i<b.size(); ++i) {b[i] = lambda*xs[i];}
+            regUpperGamma(k, b, b);
+        });
+    }
+
+    void logsf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disErlang::logsf(v); });
+    }
+
+    double quantile(const double p) const override {
+        checkProbability(p);
+        return invRegLowerGamma(k, p) / lambda;
+    }
+
+    void quantile(std::span<const double> p, std::span<double> r) const override {
+        batchEval(p, r, [this](const double v){ return disErlang::quantile(v); });
+    }
+
+    /** Gamma(k, 1/lambda). */
+    double draw(rngRef rng) const override {
+        return stdErlang(rng, k) / lambda;
+    }
+
+    void draw(rngRef rng, std::span<double> r) const override {
+        stdErlang(rng, k, r);
+        for (auto& v : r) {v /= lambda;}
     }
 
     double mean() const override {
@@ -86,6 +176,10 @@ public:
         return new disErlang(*this);
     }
 
+    pmrPtr clone(std::pmr::memory_resource* mr) const override {
+        return pmrClone(*this, mr);
+    }
+
     void print(std::ostream& output) const override {
         output << "Erlang distribution -- k = " << k << " lambda = " << lambda;
     }
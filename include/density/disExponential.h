@@ -31,11 +31,15 @@ class disExponential : public probDistr {
 private:
     double lambda;
 
+    // Derived from the parameters once, at construction.
+    double logLambda;
+
 public:
     template<class T> 
     requires std::is_arithmetic_v<T>
     disExponential(const T rate){
         lambda = rate;
+        logLambda = log(lambda);
     }
     disExponential() = delete;
 
@@ -45,7 +49,80 @@ public:
     }
 
     double cdf(const double x) const override {
-        return 1. - exp(-lambda*x);
+        return -std::expm1(x < 0 ? 0 : -lambda*x);
+    }
+
+    void pdf(std::span<const double> x, std::span<double> r) const override {
+        batchEvalBlock(x, r, [this](std::span<const double> xs, std::span<double> b){
+            for (std::size_t i=0; i<b.size(); ++i) {b[i] = -lambda*xs[i];}
+            vecExp(b, b);
+            for (double& v : b) {v *= lambda;}
+        });
+    }
+
+    void cdf(std::span<const double> x, std::span<double> r) const override {
+        batchEvalBlock(x, r, [this](std::span<const double> xs, std::span<double> b){
+            for (std::size_t i=0; i<b.size(); ++i) {b[i] = xs[i] < 0 ? 0 : -lambda*xs[i];}
+            vecExp(b, b);
+            // 1 - exp(-t) cancels below t = ln 2.
+            for (std::size_t i=0; i<b.size(); ++i) {
+                b[i] = lambda*xs[i] < M_LN2 ? disExponential::cdf(xs[i]) : 1. - b[i];
+            }
+        });
+    }
+
+    double logpdf(const double x) const override {
+        return logLambda - lambda*x;
+    }
+
+    double logcdf(const double x) const override {
+        return log1mexp(x < 0 ? 0 : lambda*x);
+    }
+
+    double sf(const double x) const override {
+        return exp(x < 0 ? 0 : -lambda*x);
+    }
+
+    double logsf(const double x) const override {
+        return x < 0 ? 0 : -lambda*x;
+    }
+
+    void logpdf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disExponential::logpdf(v); });
+    }
+
+    void logcdf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disExponential::logcdf(v); });
+    }
+
+    void sf(std::span<const double> x, std::span<double> r) const override {
+        batchEvalBlock(x, r, [this](std::span<const double> xs, std::span<double> b){
+            for (std::size_t i=0; i<b.size(); ++i) {b[i] = xs[i] < 0 ? 0 : -lambda*xs[i];}
+            vecExp(b, b);
+        });
+    }
+
+    void logsf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disExponential::logsf(v); });
+    }
+
+    double quantile(const double p) const override {
+        checkProbability(p);
+        return -std::log1p(-p)/lambda;
+    }
+
+    void quantile(std::span<const double> p, std::span<double> r) const override {
+        batchEval(p, r, [this](const double v){ return disExponential::quantile(v); });
+    }
+
+    /** Ziggurat, scaled by 1/lambda. */
+    double draw(rngRef rng) const override {
+        return stdExponential(rng) / lambda;
+    }
+
+    void draw(rngRef rng, std::span<double> r) const override {
+        stdExponential(rng, r);
+        for (auto& v : r) {v /= lambda;}
     }
 
     double mean() const override {
@@ -81,6 +158,10 @@ public:
         return new disExponential(*this);
     }
 
+    pmrPtr clone(std::pmr::memory_resource* mr) const override {
+        return pmrClone(*this, mr);
+    }
+
     void print(std::ostream& output) const override {
         output << "Exponential distribution -- lambda = " << lambda;
     }
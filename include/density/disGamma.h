@@ -33,21 +33,125 @@ private:
     double theta;
     double alpha;
 
+    // Derived from the parameters once, at construction.
+    double invTheta;    // 1/theta
+    double logNorm;     // log(1/(theta^alpha * Gamma(alpha)))
+    double logSaddle;   // -log(theta) - stirlerr(alpha-1) - log(sqrt(2 pi (alpha-1))), for alpha >= 2
+
+    /** log pdf at x > 0. For alpha >= 2 in Loader's saddle point form,
+     *  which keeps its accuracy for shapes in the millions. */
+    double logDensity(const double x) const {
+        if (alpha < 2) return (alpha-1)*log(x) - x*invTheta + logNorm;
+        return logSaddle - bd0(alpha-1, x*invTheta);
+    }
+
+    /** Block of logDensity(); the small-shape form keeps its vecLog. */
+    void logDensity(std::span<const double> xs, std::span<double> b) const {
+        if (alpha < 2) {
+            vecLog(xs, b);
+            for (std::size_t i=0; i<b.size(); ++i) {b[i] = (alpha-1)*b[i] - xs[i]*invTheta + logNorm;}
+        } else {
+            for (std::size_t i=0; i<b.size(); ++i) {b[i] = logSaddle - bd0(alpha-1, xs[i]*invTheta);}
+        }
+    }
+
 public:
     template<class T>
     requires std::is_arithmetic_v<T>
     disGamma(const T scale, const T shape) {
         theta = scale;
         alpha = shape;
+        invTheta = 1/theta;
+        logNorm = -alpha*log(theta) - std::lgamma(alpha);
+        logSaddle = alpha >= 2 ? -log(theta) - stirlerr(alpha-1) - 0.5*log(2*M_PI*(alpha-1)) : 0;
     }
     disGamma() = delete;
     
     double pdf (const double x) const override {
-        return pow(x,alpha-1)/pow(theta,alpha) * exp(-x/theta) / std::tgamma(alpha);
+        if (x > 0) return exp(logDensity(x));
+        if (x == 0) return alpha < 1 ? INFINITY : alpha == 1 ? invTheta : 0;
+        return x < 0 ? 0 : x;
     }
 
     double cdf (const double x) const override {
-        return regLowerGamma(alpha, x/theta);
+        return regLowerGamma(alpha, x*invTheta);
+    }
+
+    void pdf(std::span<const double> x, std::span<double> r) const override {
+        // Log-space: (alpha-1)*log(x) - x/theta + logNorm, or Loader's form for alpha >= 2.
+        batchEvalBlock(x, r, [this](std::span<const double> xs, std::span<double> b){
+            logDensity(xs, b);
+            vecExp(b, b);
+            for (std::size_t i=0; i<b.size(); ++i) {
+                if (!(xs[i] > 0)) b[i] = disGamma::pdf(xs[i]);
+            }
+        });
+    }
+
+    void cdf(std::span<const double> x, std::span<double> r) const override {
+        batchEvalBlock(x, r, [this](std::span<const double> xs, std::span<double> b){
+            for (std::size_t i=0; i<b.size(); ++i) {b[i] = xs[i]*invTheta;}
+            regLowerGamma(alpha, b, b);
+        });
+    }
+
+    double logpdf(const double x) const override {
+        if (!(x > 0)) return log(pdf(x));
+        return logDensity(x);
+    }
+
+    double logcdf(const double x) const override {
+        return log(cdf(x));
+    }
+
+    double sf(const double x) const override {
+        return regUpperGamma(alpha, x*invTheta);
+    }
+
+    double logsf(const double x) const override {
+        return log(sf(x));
+    }
+
+    void logpdf(std::span<const double> x, std::span<double> r) const override {
+        batchEvalBlock(x, r, [this](std::span<const double> xs, std::span<double> b){
+            logDensity(xs, b);
+            for (std::size_t i=0; i<b.size(); ++i) {
+                if (!(xs[i] > 0)) b[i] = disGamma::logpdf(xs[i]);
+            }
+        });
+    }
+
+    void logcdf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disGamma::logcdf(v); });
+    }
+
+    void sf(std::span<const double> x, std::span<double> r) const override {
+        batchEvalBlock(x, r, [this](std::span<const double> xs, std::span<double> b){
+            for (std::size_t i=0; i<b.size(); ++i) {b[i] = xs[i]*invTheta;}
+            regUpperGamma(alpha, b, b);
+        });
+    }
+
+    void logsf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disGamma::logsf(v); });
+    }
+
+    double quantile(const double p) const override {
+        checkProbability(p);
+        return theta * invRegLowerGamma(alpha, p);
+    }
+
+    void quantile(std::span<const double> p, std::span<double> r) const override {
+        batchEval(p, r, [this](const double v){ return disGamma::quantile(v); });
+    }
+
+    double draw(rngRef rng) const override {
+        return theta * stdGamma(rng, alpha);
+    }
+
+    void draw(rngRef rng, std::span<double> r) const override {
+        stdGamma(rng, alpha, r);
+        for (auto& v : r) {v *= theta;}
     }
 
     double mean() const override {
@@ -85,6 +189,10 @@ public:
         return new disGamma(*this);
     }
 
+    pmrPtr clone(std::pmr::memory_resource* mr) const override {
+        return pmrClone(*this, mr);
+    }
+
     void print(std::ostream& output) const override {
         output << "Gamma distribution -- theta = " << theta << " alpha = " << alpha;
     }
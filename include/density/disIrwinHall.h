@@ -17,16 +17,29 @@
 #define STATANALY_IRWIN_HALL_H_
 
 #include "probDistr.h"
+#include <vector>
 
 
 namespace statanaly {
 
 
 /**
- * @brief Central Chi Distribution
+ * @brief Irwin-Hall Distribution
  * 
  * Irwin–Hall random variable is defined as the sum of a number of independnet random variables.
  * 
+ * The density is a cardinal B-spline. It is evaluated with the de Boor-Cox
+ * recursion over the number of summands, which only adds non-negative terms
+ * and so stays accurate where the textbook alternating sum cancels
+ * catastrophically (n beyond ~20). The work is O(n*min(x, n-x)); for
+ * n >= edgeworthMinN an Edgeworth expansion of the standardized sum, with
+ * terms up to n^-edgeworthOrder, is used instead wherever its last term is
+ * below edgeworthTol relative to the result. Where neither applies and the
+ * recursion would exceed splineBudget, a saddle-point approximation with
+ * corrections through O(n^-2) bounds the cost; the cdf sums it over the
+ * unit-spaced densities of n+1 summands. Both sides are computed on the
+ * lower half and reflected, so cdf and sf are each accurate in their tail.
+ * 
  * @param n Num of IDD of Uniform distributions.
  */
 
@@ -35,40 +48,170 @@ private:
 
     unsigned n;
 
+    // Edgeworth expansion of the standardized sum, set up at construction
+    // when n >= edgeworthMinN. edgeCoef[j] multiplies He_j(z) in the
+    // density; edgeLast[j] is the part of it of order n^-edgeworthOrder.
+    double sigma;
+    std::vector<double> edgeCoef;
+    std::vector<double> edgeLast;
+
+    void buildEdgeworth();
+
+    /** Density (or cdf) at y <= n/2 by the de Boor-Cox recursion. */
+    double spline(const double y, const bool cumulative) const;
+
+    /** Density (or cdf) at 0 < y <= n/2 by the saddle-point approximation. */
+    double saddlepoint(const double y, const bool cumulative) const;
+
+    /** Exact recursion while it fits splineBudget, saddle point beyond. */
+    double tail(const double y, const bool cumulative) const {
+        if (double(n)*y > splineBudget) return saddlepoint(y, cumulative);
+        return spline(y, cumulative);
+    }
+
+    /**
+     * Density (or cdf) at standardized z <= 0 by the Edgeworth expansion,
+     * given g = exp(-z^2/2) and c = erfc(-z/sqrt(2)). NaN when it has not
+     * converged.
+     */
+    double edgeworth(const double z, const double g, const double c, const bool cumulative) const;
+
+    double lower(const double y, const bool cumulative) const {
+        if (std::isnan(y)) return y;
+        if (!(y >= 0)) return 0;
+        if (!edgeCoef.empty()) {
+            const double z = (y - 0.5*n) / sigma;
+            const double e = edgeworth(z, std::exp(-0.5*z*z),
+                                       cumulative ? std::erfc(-z*M_SQRT1_2) : 0, cumulative);
+            if (!std::isnan(e)) return e;
+        }
+        return tail(y, cumulative);
+    }
+
+    /** Batch of lower(); the Edgeworth terms share one vecExp and vecErfc per block. */
+    void lower(std::span<double> y, const bool cumulative) const;
+
 public:
+
+    /** Smallest n for which the Edgeworth expansion is set up. */
+    static constexpr unsigned edgeworthMinN = 64;
+
+    /** Highest power of 1/n kept in the Edgeworth expansion. */
+    static constexpr int edgeworthOrder = 8;
+
+    /** Relative size of the last Edgeworth term below which the expansion is used. */
+    static constexpr double edgeworthTol = 1e-15;
+
+    /** Largest n*x for which the de Boor-Cox recursion is run. */
+    static constexpr double splineBudget = 1 << 20;
+
     template<class T>
     requires std::is_integral_v<T>
     disIrwinHall(const T a) {
         if (a<=0) 
             throw std::runtime_error("Irwin Hall distribution takes a positive non-zero parameter.\n");
         n = a;
+        sigma = std::sqrt(n/12.);
+        buildEdgeworth();
     }
     disIrwinHall() = delete;
     ~disIrwinHall() = default;
 
     double pdf(const double x=0) const override {
-        if (x<0) return 0;
-
-        double sum = 0;
-        int sign = -1;
-        for (std::size_t k=0; k<=std::size_t(x); k++) {
-            sign = -sign;
-            sum += sign * pow(x-k,n-1) / factorial[k] / factorial[n-k];
-        }
-        double res = sum * n;
-        return res;
+        if (x >= n) return 0;
+        return lower(x <= 0.5*n ? x : n-x, false);
     }
     
     double cdf(const double x=0) const override {
-        if (x<0) return 0;
+        if (x <= 0.5*n) return lower(x, true);
+        return 1 - lower(n-x, true);
+    }
 
-        double sum = 0;
-        int sign = -1;
-        for (std::size_t k=0; k<=std::size_t(x); k++) {
-            sign = -sign;
-            sum += sign * pow(x-k,n-1) / factorial[k] / factorial[n-k];
+    double sf(const double x) const override {
+        if (x >= 0.5*n) return lower(n-x, true);
+        return 1 - lower(x, true);
+    }
+
+    double logsf(const double x) const override {
+        return log(sf(x));
+    }
+
+    void pdf(std::span<const double> x, std::span<double> r) const override {
+        batchEvalBlock(x, r, [this](std::span<const double> xs, std::span<double> b){
+            for (std::size_t i=0; i<b.size(); ++i) {b[i] = xs[i] <= 0.5*n ? xs[i] : n-xs[i];}
+            lower(b, false);
+            for (std::size_t i=0; i<b.size(); ++i) {
+                if (xs[i] >= n) b[i] = 0;
+            }
+        });
+    }
+
+    void cdf(std::span<const double> x, std::span<double> r) const override {
+        batchEvalBlock(x, r, [this](std::span<const double> xs, std::span<double> b){
+            for (std::size_t i=0; i<b.size(); ++i) {b[i] = xs[i] <= 0.5*n ? xs[i] : n-xs[i];}
+            lower(b, true);
+            for (std::size_t i=0; i<b.size(); ++i) {
+                if (xs[i] > 0.5*n) b[i] = 1 - b[i];
+            }
+        });
+    }
+
+    void sf(std::span<const double> x, std::span<double> r) const override {
+        batchEvalBlock(x, r, [this](std::span<const double> xs, std::span<double> b){
+            for (std::size_t i=0; i<b.size(); ++i) {b[i] = xs[i] >= 0.5*n ? n-xs[i] : xs[i];}
+            lower(b, true);
+            for (std::size_t i=0; i<b.size(); ++i) {
+                if (xs[i] < 0.5*n) b[i] = 1 - b[i];
+            }
+        });
+    }
+
+    void logsf(std::span<const double> x, std::span<double> r) const override {
+        sf(x, r);
+        vecLog(r.first(x.size()), r.first(x.size()));
+    }
+
+    /**
+     * Solved on the support [0, n], in the lower half; the upper half is
+     * reflected, since the cdf rounds to 1 there. 1-p is exact for p > 1/2.
+     */
+    double quantile(const double p) const override {
+        checkProbability(p);
+        if (p == 0) return 0;
+        if (p == 1) return n;
+        if (p > 0.5) return n - quantile(1-p);
+        return solveQuantile(p, 0., 0.5*n, 0.25*n,
+            [this](const double x){ return disIrwinHall::cdf(x); },
+            [this](const double x){ return disIrwinHall::pdf(x); });
+    }
+
+    void quantile(std::span<const double> p, std::span<double> r) const override {
+        batchEval(p, r, [this](const double v){ return disIrwinHall::quantile(v); });
+    }
+
+    /** Sum of n standard uniforms. */
+    double draw(rngRef rng) const override {
+        double s = 0;
+        for (unsigned i=0; i<n; ++i) {s += toUnit(rng());}
+        return s;
+    }
+
+    void draw(rngRef rng, std::span<double> r) const override {
+        constexpr std::size_t B = 256;
+        std::uint64_t w[B];
+        std::size_t left = r.size()*n, used = B;
+        for (auto& v : r) {
+            double s = 0;
+            for (unsigned i=0; i<n; ++i) {
+                if (used == B) {
+                    rng.fill(std::span<std::uint64_t>(w, std::min(B, left)));
+                    left -= std::min(B, left);
+                    used = 0;
+                }
+                s += toUnit(w[used++]);
+            }
+            v = s;
         }
-        return sum;
     }
 
     double mean() const override {
@@ -102,6 +245,10 @@ public:
         return new disIrwinHall(*this);
     }
 
+    pmrPtr clone(std::pmr::memory_resource* mr) const override {
+        return pmrClone(*this, mr);
+    }
+
     void print(std::ostream& output) const override {
         output << "Irwin Hall distribution -- n = " << n;
     }
@@ -43,13 +43,28 @@ class disMixture : public probDistr {
     dCtr ctr;
 
 public:
+    /** With an allocator, the components live in its memory resource; see dCtr. */
+    using allocator_type = dCtr::allocator_type;
+
     disMixture() = default;
+    explicit disMixture(const allocator_type& a) : ctr(a) {}
+
+    /**
+     * @brief A mixture of (distribution, weight) pairs, built at once.
+     * 
+     * Declared const, the mixture is frozen: the components and weights are
+     * fixed, and its alias table and type groups are built only once.
+     * @see dCtr::insertMany
+     */
+    template<std::ranges::range R>
+    explicit disMixture(R&& items, const bool merge=false, const allocator_type& a={})
+        : ctr(std::forward<R>(items), merge, a) {}
 
     /** Copy constructor: deep-copy, do the same as clone(). */
-    disMixture(const disMixture& o) {
-        // clone the container.
-        ctr = o.ctr;
-    }
+    disMixture(const disMixture& o) : ctr(o.ctr) {}
+
+    /** Deep-copy into a's memory resource; clone(mr) comes here. */
+    disMixture(const disMixture& o, const allocator_type& a) : ctr(o.ctr, a) {}
 
     /** Copy assignment: deep-copy */
     disMixture& operator = (const disMixture& o) {
@@ -58,16 +73,12 @@ public:
         return *this;
     };
     
-    /** Move constructor.
-     */
-    disMixture(disMixture&& o) {
-        std::swap(ctr, o.ctr);
-    }
+    /** Move constructor: the container, and its memory resource, move along. */
+    disMixture(disMixture&& o) : ctr(std::move(o.ctr)) {}
 
-    /** Move assignment */
+    /** Move assignment; copies when o lives in another memory resource. */
     disMixture& operator = (disMixture&& o) {
-        // Move the named distribution.
-        std::swap(ctr, o.ctr);
+        ctr = std::move(o.ctr);
         return *this;
     }
 
@@ -79,12 +90,22 @@ public:
         return new disMixture(*this);
     };
 
-    /** Insert a distribution and its weight */
+    pmrPtr clone(std::pmr::memory_resource* mr) const override {
+        return pmrClone(*this, mr);
+    }
+
+    /** Insert a distribution and its weight; with merge, an equal component's weight grows instead. */
     template<typename F, typename W>
     requires std::is_arithmetic_v<W>
-    void insert(F&& distr, W weight) {
+    void insert(F&& distr, W weight, const bool merge=false) {
         // Forward to container's insert.
-        ctr.insert( std::forward<F>(distr), weight);
+        ctr.insert( std::forward<F>(distr), weight, merge);
+    }
+
+    /** Insert many (distribution, weight) pairs, rescaling the weights once. */
+    template<std::ranges::range R>
+    void insertMany(R&& items, const bool merge=false) {
+        ctr.insertMany( std::forward<R>(items), merge);
     }
 
     /** Find a distribution in the mixture.
@@ -99,24 +120,108 @@ public:
     inline const auto end() const {return ctr.end();}
     inline void clear() {ctr.clear();}
 
-    /** pdf of a mixture is the weighted sum of pdf of each component. */
+    /**
+     * @brief Merge normal components down to at most maxComponents, or
+     * until a merge would cost more than maxCost; mean and variance of the
+     * mixture are preserved. The cost of a pdf() call falls with them.
+     * @see dCtr::reduce
+     */
+    double reduce(const std::size_t maxComponents,
+                  const double maxCost = std::numeric_limits<double>::infinity()) {
+        return ctr.reduce(maxComponents, maxCost);
+    }
+
+    allocator_type get_allocator() const noexcept {return ctr.get_allocator();}
+
+    /** pdf of a mixture is the weighted sum of pdf of each component,
+     * evaluated group by group over the container's type groups. */
     double pdf(const double x) const override {
-        double res = 0;
-        for (const auto& [d, ws] : ctr.get()) {
-            const double w = ws.second;
-            res += d->pdf(x) * w;
-        }
-        return res;
+        return ctr.groups()->pdf(x);
     }
 
     /** cdf of a mixture is the weighted sum of cdf of each component. */
     double cdf(const double x) const override {
-        double res = 0;
-        for (const auto& [d, ws] : ctr.get()) {
-            const double w = ws.second;
-            res += d->cdf(x) * w;
+        return ctr.groups()->cdf(x);
+    }
+
+    /** sf of a mixture is the weighted sum of sf of each component. */
+    double sf(const double x) const override {
+        return ctr.groups()->sf(x);
+    }
+
+    /** Log functions of a mixture -- log-sum-exp over the weighted components,
+     * so tails far below the double range of pdf/cdf stay finite. */
+    double logpdf(const double x) const override {
+        return logSum(x, &probDistr::logpdf);
+    }
+
+    double logcdf(const double x) const override {
+        return logSum(x, &probDistr::logcdf);
+    }
+
+    double logsf(const double x) const override {
+        return logSum(x, &probDistr::logsf);
+    }
+
+    /** Batch pdf -- group by group, over blocks of x. */
+    void pdf(std::span<const double> x, std::span<double> r) const override {
+        ctr.groups()->pdf(x, r);
+    }
+
+    /** Batch cdf -- group by group, over blocks of x. */
+    void cdf(std::span<const double> x, std::span<double> r) const override {
+        ctr.groups()->cdf(x, r);
+    }
+
+    /** Batch sf -- group by group, over blocks of x. */
+    void sf(std::span<const double> x, std::span<double> r) const override {
+        ctr.groups()->sf(x, r);
+    }
+
+    void logpdf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disMixture::logpdf(v); });
+    }
+
+    void logcdf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disMixture::logcdf(v); });
+    }
+
+    void logsf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disMixture::logsf(v); });
+    }
+
+    /** Picks a component with probability of its weight, in O(1) from the
+     * container's alias table, then draws from it. */
+    double draw(rngRef rng) const override {
+        const auto t = aliasOf();
+        return t->comp[t->pick(rng())]->draw(rng);
+    }
+
+    /** Components are picked for a block of draws at once; then each
+     * component fills its share with one batch draw. */
+    void draw(rngRef rng, std::span<double> r) const override {
+        const auto t = aliasOf();
+        constexpr std::size_t B = 4096;
+        std::vector<std::uint64_t> key(std::min(B, r.size()));
+        std::vector<double> tmp(key.size());
+        for (std::size_t s = 0; s < r.size(); s += B) {
+            const std::size_t m = std::min(B, r.size() - s);
+            rng.fill(std::span<std::uint64_t>(key.data(), m));
+
+            // (component, position) in one word; sorting groups the components.
+            for (std::size_t i = 0; i < m; ++i) {key[i] = (std::uint64_t(t->pick(key[i])) << 32) | i;}
+            std::sort(key.begin(), key.begin() + m);
+
+            for (std::size_t a = 0; a < m;) {
+                const std::uint64_t c = key[a] >> 32;
+                std::size_t b = a;
+                while (b < m && (key[b] >> 32) == c) {++b;}
+                const std::span<double> part(tmp.data(), b - a);
+                t->comp[c]->draw(rng, part);
+                for (std::size_t i = a; i < b; ++i) {r[s + std::uint32_t(key[i])] = part[i - a];}
+                a = b;
+            }
         }
-        return res;
     }
 
     /** mean of a mixture is the weighted sum of mean of each component. */
@@ -189,6 +294,30 @@ public:
 
     virtual dFuncID getID() const {return id;};
     const dFuncID id = dFuncID::MIXTURE_DISTR;
+
+private:
+    std::shared_ptr<const dAliasTable> aliasOf() const {
+        if (ctr.get().empty()) throw std::runtime_error("Cannot sample from an empty mixture.");
+        return ctr.aliasTable();
+    }
+
+    using logFn = double (probDistr::*)(const double) const;
+
+    /** log(sum_i w_i * exp(f_i(x))), accumulated in one pass with a running maximum. */
+    double logSum(const double x, logFn f) const {
+        double m = -INFINITY, s = 0;
+        for (const auto& [d, ws] : ctr.get()) {
+            const double v = log(ws.second) + (d->*f)(x);
+            if (v == -INFINITY) continue;
+            if (v <= m) {
+                s += exp(v-m);
+            } else {
+                s = s*exp(m-v) + 1;
+                m = v;
+            }
+        }
+        return m + log(s);
+    }
 };
 
 } // namespace 
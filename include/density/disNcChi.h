@@ -17,6 +17,7 @@
 #define STATANALY_DIS_NONCENTRAL_CHI_H_
 
 #include "probDistr.h"
+#include "disNcChiSq.h"
 
 namespace statanaly {
 
@@ -34,6 +35,10 @@ private:
     unsigned k;
     double lambda;
 
+    // Derived from the parameters once, at construction.
+    double kh;          // k/2
+    double lambdaSq;    // lambda^2
+
 public:
 
     template<class T, class U>
@@ -41,18 +46,80 @@ public:
     disNcChi(const T dof, const U distance) {
         k = dof;
         lambda = distance;
+        kh = 0.5*k;
+        lambdaSq = lambda*lambda;
     }
     disNcChi() = delete;
     ~disNcChi() = default;
 
     double pdf(const double x) const override {
-        const double kh = 0.5*k;
-        const double t = lambda * pow(x/lambda,kh) * exp(-0.5*(x*x+lambda*lambda));
+        const double t = lambda * pow(x/lambda,kh) * exp(-0.5*(x*x+lambdaSq));
         return t * std::cyl_bessel_i(kh-1., lambda*x);
     }
 
     double cdf(const double x) const override {
-        return 1. - marcumQ(0.5*k,lambda,x);
+        return marcumP(kh,lambda,x);
+    }
+
+    void pdf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disNcChi::pdf(v); });
+    }
+
+    void cdf(std::span<const double> x, std::span<double> r) const override {
+        marcumP(kh, lambda, x, r);
+    }
+
+    double logpdf(const double x) const override {
+        if (!(x > 0)) return log(pdf(x));
+        return log(lambda) + kh*log(x/lambda) - 0.5*(x*x+lambdaSq)
+            + logBesselI(kh-1., lambda*x);
+    }
+
+    double logcdf(const double x) const override {
+        return log(cdf(x));
+    }
+
+    double sf(const double x) const override {
+        return marcumQ(kh,lambda,x);
+    }
+
+    double logsf(const double x) const override {
+        return log(sf(x));
+    }
+
+    void logpdf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disNcChi::logpdf(v); });
+    }
+
+    void logcdf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disNcChi::logcdf(v); });
+    }
+
+    void sf(std::span<const double> x, std::span<double> r) const override {
+        marcumQ(kh, lambda, x, r);
+    }
+
+    void logsf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disNcChi::logsf(v); });
+    }
+
+    /** X is Chi when X^2 is ChiSq with the squared distance. */
+    double quantile(const double p) const override {
+        checkProbability(p);
+        return std::sqrt(disNcChiSq(k, lambdaSq).quantile(p));
+    }
+
+    void quantile(std::span<const double> p, std::span<double> r) const override {
+        batchEval(p, r, [this](const double v){ return disNcChi::quantile(v); });
+    }
+
+    /** Square root of a non-central chi-squared variate with distance lambda^2. */
+    double draw(rngRef rng) const override {
+        return std::sqrt(2*stdGamma(rng, kh + stdPoisson(rng, 0.5*lambdaSq)));
+    }
+
+    void draw(rngRef rng, std::span<double> r) const override {
+        for (auto& v : r) {v = disNcChi::draw(rng);}
     }
 
     double mean() const override {
@@ -96,6 +163,10 @@ public:
         return new disNcChi(*this);
     }
 
+    pmrPtr clone(std::pmr::memory_resource* mr) const override {
+        return pmrClone(*this, mr);
+    }
+
     void print(std::ostream& output) const override {
         output << "Non-central Chi distribution -- k = " << k << " lambda = " << lambda;
     }
@@ -116,6 +187,9 @@ public:
         return r;
     }
 
+    virtual dFuncID getID() const {return id;};
+    const dFuncID id = dFuncID::NC_CHI_DISTR;
+
     auto p_dof() const noexcept{
         return k;
     }
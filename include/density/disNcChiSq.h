@@ -35,24 +35,111 @@ private:
     unsigned k;
     double lambda;
 
+    // Derived from the parameters once, at construction.
+    double kp;          // k/2-1, order of the Bessel function
+    double sqrtLambda;  // sqrt(lambda)
+
 public:
     template<class T, class U>
     requires std::is_integral_v<T> && std::is_arithmetic_v<U>
     disNcChiSq(const T dof, const U distance) {
         k = dof;
         lambda = distance;
+        kp = 0.5*k - 1.;
+        sqrtLambda = std::sqrt(lambda);
     }
     disNcChiSq() = delete;
     ~disNcChiSq() = default;
 
     double pdf(const double x) const override {
-        const double kp = 0.5*k - 1.;
         const double t = 0.5 * pow(x/lambda, 0.5*kp) * exp(-0.5*(x+lambda));
-        return t * std::cyl_bessel_i(kp, std::sqrt(lambda*x));
+        return t * std::cyl_bessel_i(kp, sqrtLambda*std::sqrt(x));
     }
 
     double cdf(const double x) const override {
-        return 1. - marcumQ(0.5*k, std::sqrt(lambda), std::sqrt(x));
+        return _marcumQHalfSq(0.5*k, 0.5*lambda, 0.5*x, true);
+    }
+
+    void pdf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disNcChiSq::pdf(v); });
+    }
+
+    void cdf(std::span<const double> x, std::span<double> r) const override {
+        batchEvalBlock(x, r, [this](std::span<const double> xs, std::span<double> b){
+            for (std::size_t i=0; i<b.size(); ++i) {b[i] = 0.5*xs[i];}
+            _marcumQHalfSq(0.5*k, 0.5*lambda, b, b, true);
+        });
+    }
+
+    double logpdf(const double x) const override {
+        if (!(x > 0)) return log(pdf(x));
+        return -M_LN2 + 0.5*kp*log(x/lambda) - 0.5*(x+lambda)
+            + logBesselI(kp, sqrtLambda*std::sqrt(x));
+    }
+
+    double logcdf(const double x) const override {
+        return log(cdf(x));
+    }
+
+    double sf(const double x) const override {
+        return _marcumQHalfSq(0.5*k, 0.5*lambda, 0.5*x, false);
+    }
+
+    double logsf(const double x) const override {
+        return log(sf(x));
+    }
+
+    void logpdf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disNcChiSq::logpdf(v); });
+    }
+
+    void logcdf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disNcChiSq::logcdf(v); });
+    }
+
+    void sf(std::span<const double> x, std::span<double> r) const override {
+        batchEvalBlock(x, r, [this](std::span<const double> xs, std::span<double> b){
+            for (std::size_t i=0; i<b.size(); ++i) {b[i] = 0.5*xs[i];}
+            _marcumQHalfSq(0.5*k, 0.5*lambda, b, b, false);
+        });
+    }
+
+    void logsf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disNcChiSq::logsf(v); });
+    }
+
+    /** Newton's method from Patnaik's central approximation. */
+    double quantile(const double p) const override {
+        checkProbability(p);
+        if (p == 0) return 0;
+        if (p == 1) return INFINITY;
+
+        // Patnaik's approximation c*ChiSq(nu), matching the first two moments.
+        const double c  = (k+2*lambda)/(k+lambda);
+        const double nu = (k+lambda)*(k+lambda)/(k+2*lambda);
+        const double x0 = 2*c*invRegLowerGamma(0.5*nu, p);
+
+        double lo = 0, hi = std::max(2*x0, 1.);
+        while (cdf(hi) < p) {
+            lo = hi;
+            hi *= 2;
+        }
+        return solveQuantile(p, lo, hi, x0,
+            [this](const double x){ return disNcChiSq::cdf(x); },
+            [this](const double x){ return disNcChiSq::pdf(x); });
+    }
+
+    void quantile(std::span<const double> p, std::span<double> r) const override {
+        batchEval(p, r, [this](const double v){ return disNcChiSq::quantile(v); });
+    }
+
+    /** Poisson mixture of central chi-squares: ChiSq(k+2N), N ~ Poisson(lambda/2). */
+    double draw(rngRef rng) const override {
+        return 2*stdGamma(rng, 0.5*k + stdPoisson(rng, 0.5*lambda));
+    }
+
+    void draw(rngRef rng, std::span<double> r) const override {
+        for (auto& v : r) {v = disNcChiSq::draw(rng);}
     }
 
     double mean() const override {
@@ -87,6 +174,10 @@ public:
         return new disNcChiSq(*this);
     }
 
+    pmrPtr clone(std::pmr::memory_resource* mr) const override {
+        return pmrClone(*this, mr);
+    }
+
     void print(std::ostream& output) const override {
         output << "Non-central Chi-Sqaured distribution -- k = " << k << " lambda = " << lambda;
     }
@@ -107,6 +198,9 @@ public:
         return r;
     }
 
+    virtual dFuncID getID() const {return id;};
+    const dFuncID id = dFuncID::NC_CHISQ_DISTR;
+
     auto p_dof() const noexcept {
         return k;
     }
@@ -36,6 +36,10 @@ private:
     double mu;
     double sig;
 
+    // Derived from the parameters once, at construction.
+    double invSig;      // 1/sig
+    double logNorm;     // -log(sig*sqrt(2*pi))
+
 public:
 
     template<class T, class U> 
@@ -43,19 +47,94 @@ public:
     disNormal(const T mean, const U variance){
         mu = mean;
         sig = sqrt(variance);
+        invSig = 1/sig;
+        logNorm = -log(sig) - SACV_LOG_SQRT_2PI;
     }
     disNormal() = delete;
     ~disNormal() = default;
 
     double pdf(const double x) const override {
-        const double x_scaled = ((x-mu)/sig) * ((x-mu)/sig);
-        const double r = exp(-log(sig) - SACV_LOG_SQRT_2PI - 0.5*x_scaled);
-        return r;
+        const double z = (x-mu)*invSig;
+        return exp(logNorm - 0.5*z*z);
     }
 
     double cdf(const double x) const override {
-        const double scaledx = (x-mu)/sig;
-        return 0.5 * (1. + std::erf(scaledx * M_SQRT1_2));
+        // erfc form keeps full relative accuracy in the lower tail.
+        const double scaledx = (x-mu)*invSig;
+        return 0.5 * std::erfc(-scaledx * M_SQRT1_2);
+    }
+
+    void pdf(std::span<const double> x, std::span<double> r) const override {
+        batchEvalBlock(x, r, [this](std::span<const double> xs, std::span<double> b){
+            for (std::size_t i=0; i<b.size(); ++i) {
+                const double z = (xs[i]-mu)*invSig;
+                b[i] = logNorm - 0.5*z*z;
+            }
+            vecExp(b, b);
+        });
+    }
+
+    void cdf(std::span<const double> x, std::span<double> r) const override {
+        batchEvalBlock(x, r, [this](std::span<const double> xs, std::span<double> b){
+            for (std::size_t i=0; i<b.size(); ++i) {b[i] = (mu-xs[i])*invSig * M_SQRT1_2;}
+            vecErfc(b, b);
+            for (double& v : b) {v *= 0.5;}
+        });
+    }
+
+    double logpdf(const double x) const override {
+        const double z = (x-mu)*invSig;
+        return logNorm - 0.5*z*z;
+    }
+
+    double logcdf(const double x) const override {
+        return logErfc((mu-x)*invSig * M_SQRT1_2) - M_LN2;
+    }
+
+    double sf(const double x) const override {
+        return 0.5 * std::erfc((x-mu)*invSig * M_SQRT1_2);
+    }
+
+    double logsf(const double x) const override {
+        return logErfc((x-mu)*invSig * M_SQRT1_2) - M_LN2;
+    }
+
+    void logpdf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disNormal::logpdf(v); });
+    }
+
+    void logcdf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disNormal::logcdf(v); });
+    }
+
+    void sf(std::span<const double> x, std::span<double> r) const override {
+        batchEvalBlock(x, r, [this](std::span<const double> xs, std::span<double> b){
+            for (std::size_t i=0; i<b.size(); ++i) {b[i] = (xs[i]-mu)*invSig * M_SQRT1_2;}
+            vecErfc(b, b);
+            for (double& v : b) {v *= 0.5;}
+        });
+    }
+
+    void logsf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disNormal::logsf(v); });
+    }
+
+    double quantile(const double p) const override {
+        checkProbability(p);
+        return mu + sig*invNormalCdf(p);
+    }
+
+    void quantile(std::span<const double> p, std::span<double> r) const override {
+        batchEval(p, r, [this](const double v){ return disNormal::quantile(v); });
+    }
+
+    double draw(rngRef rng) const override {
+        return mu + sig*stdNormal(rng);
+    }
+
+    void draw(rngRef rng, std::span<double> r) const override {
+        stdNormal(rng, r);
+        for (auto& v : r) {v = mu + sig*v;}
     }
 
     double mean() const override {
@@ -90,6 +169,10 @@ public:
         return new disNormal(*this);
     }
 
+    pmrPtr clone(std::pmr::memory_resource* mr) const override {
+        return pmrClone(*this, mr);
+    }
+
     void print(std::ostream& output) const override {
         output << "Normal distribution -- mu = " << mu << "  sig = " << sig;
     }
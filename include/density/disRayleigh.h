@@ -33,25 +33,106 @@ private:
 
     double sigma;
 
+    // Derived from the parameters once, at construction.
+    double inv_ss;      // 1/sigma^2
+
 public:
 
     template<class T>
     requires std::is_arithmetic_v<T>
     disRayleigh(const T scale) {
         sigma = scale;
+        inv_ss = 1/(sigma*sigma);
     }
     disRayleigh() = delete;
     ~disRayleigh() = default;
 
     double pdf(const double x) const override {
-        const double inv_ss = 1/(sigma*sigma);
-        const double r = x*inv_ss * std::exp(-0.5*x*x*inv_ss);
-        return r;
+        return x*inv_ss * std::exp(-0.5*x*x*inv_ss);
     }
 
     double cdf(const double x) const override {
-        const double s = std::exp(-0.5*x*x/(sigma*sigma));
-        return 1-s;
+        return -std::expm1(x < 0 ? 0 : -0.5*x*x*inv_ss);
+    }
+
+    void pdf(std::span<const double> x, std::span<double> r) const override {
+        batchEvalBlock(x, r, [this](std::span<const double> xs, std::span<double> b){
+            for (std::size_t i=0; i<b.size(); ++i) {b[i] = -0.5*xs[i]*xs[i]*inv_ss;}
+            vecExp(b, b);
+            for (std::size_t i=0; i<b.size(); ++i) {b[i] *= xs[i]*inv_ss;}
+        });
+    }
+
+    void cdf(std::span<const double> x, std::span<double> r) const override {
+        batchEvalBlock(x, r, [this](std::span<const double> xs, std::span<double> b){
+            for (std::size_t i=0; i<b.size(); ++i) {b[i] = xs[i] < 0 ? 0 : -0.5*xs[i]*xs[i]*inv_ss;}
+            vecExp(b, b);
+            // 1 - exp(-t) cancels below t = ln 2.
+            for (std::size_t i=0; i<b.size(); ++i) {
+                b[i] = 0.5*xs[i]*xs[i]*inv_ss < M_LN2 ? disRayleigh::cdf(xs[i]) : 1. - b[i];
+            }
+        });
+    }
+
+    double logpdf(const double x) const override {
+        if (!(x > 0)) return log(pdf(x));
+        return log(x*inv_ss) - 0.5*x*x*inv_ss;
+    }
+
+    double logcdf(const double x) const override {
+        return log1mexp(x < 0 ? 0 : 0.5*x*x*inv_ss);
+    }
+
+    double sf(const double x) const override {
+        return std::exp(x < 0 ? 0 : -0.5*x*x*inv_ss);
+    }
+
+    double logsf(const double x) const override {
+        return x < 0 ? 0 : -0.5*x*x*inv_ss;
+    }
+
+    void logpdf(std::span<const double> x, std::span<double> r) const override {
+        batchEvalBlock(x, r, [this](std::span<const double> xs, std::span<double> b){
+            for (std::size_t i=0; i<b.size(); ++i) {b[i] = xs[i]*inv_ss;}
+            vecLog(b, b);
+            for (std::size_t i=0; i<b.size(); ++i) {
+                b[i] = xs[i] > 0 ? b[i] - 0.5*xs[i]*xs[i]*inv_ss : disRayleigh::logpdf(xs[i]);
+            }
+        });
+    }
+
+    void logcdf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disRayleigh::logcdf(v); });
+    }
+
+    void sf(std::span<const double> x, std::span<double> r) const override {
+        batchEvalBlock(x, r, [this](std::span<const double> xs, std::span<double> b){
+            for (std::size_t i=0; i<b.size(); ++i) {b[i] = xs[i] < 0 ? 0 : -0.5*xs[i]*xs[i]*inv_ss;}
+            vecExp(b, b);
+        });
+    }
+
+    void logsf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disRayleigh::logsf(v); });
+    }
+
+    double quantile(const double p) const override {
+        checkProbability(p);
+        return sigma * std::sqrt(-2*std::log1p(-p));
+    }
+
+    void quantile(std::span<const double> p, std::span<double> r) const override {
+        batchEval(p, r, [this](const double v){ return disRayleigh::quantile(v); });
+    }
+
+    /** sigma*sqrt(2E), E standard exponential. */
+    double draw(rngRef rng) const override {
+        return sigma * std::sqrt(2*stdExponential(rng));
+    }
+
+    void draw(rngRef rng, std::span<double> r) const override {
+        stdExponential(rng, r);
+        for (auto& v : r) {v = sigma * std::sqrt(2*v);}
     }
 
     double mean() const override {
@@ -89,6 +170,10 @@ public:
         return new disRayleigh(*this);
     }
 
+    pmrPtr clone(std::pmr::memory_resource* mr) const override {
+        return pmrClone(*this, mr);
+    }
+
     void print(std::ostream& output) const override {
         output << "Rayleigh distribution -- sigma = " << sigma;
     }
@@ -18,6 +18,7 @@
 
 #include "probDistr.h"
 #include "disNcChi.h"
+#include "disNcChiSq.h"
 
 
 namespace statanaly {
@@ -35,25 +36,107 @@ private:
     double nu;      // distance
     double sigma;   // scale
 
+    // Derived from the parameters once, at construction.
+    double s2inv;   // 1/sigma^2
+    double s_inv;   // 1/sigma
+
 public:
     template<class T, class U>
     requires std::is_arithmetic_v<T> && std::is_arithmetic_v<U> 
     disRician(const T distance, const U scale) {
         nu = std::abs(distance);
         sigma = scale;
+        s_inv = 1/sigma;
+        s2inv = s_inv*s_inv;
     }
     disRician() = delete;
     ~disRician() = default;
 
     double pdf(const double x) const override {
-        const double s2inv = 1/(sigma*sigma);
         const double x_e = exp(-(x*x+nu*nu)*0.5*s2inv) * std::cyl_bessel_i(0,x*nu*s2inv);
         return x * s2inv * x_e;
     }
 
     double cdf(const double x) const override {
-        const double s_inv = 1/sigma;
-        return 1 - marcumQ(1, nu*s_inv, x*s_inv);
+        return marcumP(1, nu*s_inv, x*s_inv);
+    }
+
+    void pdf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disRician::pdf(v); });
+    }
+
+    void cdf(std::span<const double> x, std::span<double> r) const override {
+        batchEvalBlock(x, r, [this](std::span<const double> xs, std::span<double> b){
+            for (std::size_t i=0; i<b.size(); ++i) {b[i] = xs[i]*s_inv;}
+            marcumP(1., nu*s_inv, b, b);
+        });
+    }
+
+    double logpdf(const double x) const override {
+        if (!(x > 0)) return log(pdf(x));
+        return log(x*s2inv) - (x*x+nu*nu)*0.5*s2inv
+            + logBesselI(0, x*nu*s2inv);
+    }
+
+    double logcdf(const double x) const override {
+        return log(cdf(x));
+    }
+
+    double sf(const double x) const override {
+        return marcumQ(1, nu*s_inv, x*s_inv);
+    }
+
+    double logsf(const double x) const override {
+        return log(sf(x));
+    }
+
+    void logpdf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disRician::logpdf(v); });
+    }
+
+    void logcdf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disRician::logcdf(v); });
+    }
+
+    void sf(std::span<const double> x, std::span<double> r) const override {
+        batchEvalBlock(x, r, [this](std::span<const double> xs, std::span<double> b){
+            for (std::size_t i=0; i<b.size(); ++i) {b[i] = xs[i]*s_inv;}
+            marcumQ(1., nu*s_inv, b, b);
+        });
+    }
+
+    void logsf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disRician::logsf(v); });
+    }
+
+    /** (X/sigma)^2 is a non-central ChiSq with k = 2 and distance (nu/sigma)^2. */
+    double quantile(const double p) const override {
+        checkProbability(p);
+        return sigma * std::sqrt(disNcChiSq(2, nu*nu*s2inv).quantile(p));
+    }
+
+    void quantile(std::span<const double> p, std::span<double> r) const override {
+        batchEval(p, r, [this](const double v){ return disRician::quantile(v); });
+    }
+
+    /** Length of a 2D normal vector with mean (nu, 0) and deviation sigma. */
+    double draw(rngRef rng) const override {
+        const double x = nu + sigma*stdNormal(rng);
+        const double y = sigma*stdNormal(rng);
+        return std::sqrt(x*x + y*y);
+    }
+
+    void draw(rngRef rng, std::span<double> r) const override {
+        double z[256];
+        for (std::size_t s = 0; s < r.size(); s += 128) {
+            const std::size_t m = std::min<std::size_t>(128, r.size() - s);
+            stdNormal(rng, std::span<double>(z, 2*m));
+            for (std::size_t i=0; i<m; ++i) {
+                const double x = nu + sigma*z[2*i];
+                const double y = sigma*z[2*i+1];
+                r[s+i] = std::sqrt(x*x + y*y);
+            }
+        }
     }
 
     double mean() const override {
@@ -95,6 +178,10 @@ public:
         return new disRician(*this);
     }
 
+    pmrPtr clone(std::pmr::memory_resource* mr) const override {
+        return pmrClone(*this, mr);
+    }
+
     void print(std::ostream& output) const override {
         output << "Rician distribution -- nu = " << nu << " sigma = " << sigma;
     }
@@ -115,6 +202,9 @@ public:
         return r;
     }
 
+    virtual dFuncID getID() const {return id;};
+    const dFuncID id = dFuncID::RICIAN_DISTR;
+
     auto p_distance() const noexcept {
         return nu;
     }
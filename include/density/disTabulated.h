@@ -0,0 +1,260 @@
+/*
+   Copyright 2022, Ansel Blumers
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef STATANALY_DIS_TABULATED_H_
+#define STATANALY_DIS_TABULATED_H_
+
+#include "probDistr.h"
+#include <vector>
+
+namespace statanaly {
+
+/**
+ * @brief Tabulated approximation of a distribution
+ *
+ * Wraps any distribution and replaces its pdf and cdf on [lo, hi] by
+ * piecewise Chebyshev interpolants. A lookup is a panel index plus one
+ * Clenshaw recurrence of fixed degree, independent of how expensive the
+ * wrapped distribution is (eg. the Marcum-Q based cdf of disNcChiSq,
+ * disNcChi and disRician).
+ *
+ * Panels are bisected until the absolute error, measured against the exact
+ * distribution between the interpolation nodes and at the panel ends, is
+ * within tol, so they are short only where the distribution is hard to fit
+ * (eg. the sqrt(x) pdf of a 3 degrees-of-freedom chi-square near 0).
+ * Refinement stops at maxPanels panels. The achieved error is reported by maxErrorPdf() and maxErrorCdf().
+ *
+ * Outside [lo, hi] every call goes to the exact distribution.
+ * Moments are always forwarded to the exact distribution.
+ *
+ * @param distr Distribution to tabulate. It is deep-copied.
+ * @param lo Lower end of the tabulated range.
+ * @param hi Upper end of the tabulated range.
+ * @param tol Requested absolute error of pdf and cdf.
+ */
+
+class disTabulated : public probDistr {
+private:
+
+    std::unique_ptr<probDistr> exact;
+    double lo;
+    double hi;
+    double tol;
+
+    std::size_t nPanel = 0;
+    std::vector<double> edges;      // nPanel+1 panel boundaries
+    std::vector<double> pdfCoef;    // nPanel x NCOEF Chebyshev coefficients
+    std::vector<double> cdfCoef;
+    double errPdf = 0;
+    double errCdf = 0;
+
+    // Uniform grid over [lo, hi]; cell g starts in panel cell[g]. It
+    // narrows the panel search to the few panels overlapping one cell.
+    std::vector<std::size_t> cell;
+    double invCell = 0;
+
+    void build();
+
+    std::size_t panelOf(const double x) const {
+        std::size_t g = static_cast<std::size_t>((x-lo)*invCell);
+        if (g >= cell.size()-1) g = cell.size()-2;
+        const auto first = edges.begin() + cell[g] + 1;
+        const auto last = edges.begin() + cell[g+1] + 1;
+        return std::upper_bound(first, last, x) - edges.begin() - 1;
+    }
+
+    /** Clenshaw recurrence of the coefficients of the panel holding x. */
+    double interp(const std::vector<double>& coef, const double x) const {
+        const std::size_t i = panelOf(x);
+        const double a = edges[i], b = edges[i+1];
+        const double t2 = 2*(2*x - a - b)/(b - a);
+        const double* c = coef.data() + i*NCOEF;
+        double b1 = 0, b2 = 0;
+        for (std::size_t k = NCOEF-1; k > 0; --k) {
+            const double b0 = t2*b1 - b2 + c[k];
+            b2 = b1;
+            b1 = b0;
+        }
+        return 0.5*t2*b1 - b2 + c[0];
+    }
+
+    bool inRange(const double x) const {
+        return lo <= x && x <= hi;
+    }
+
+public:
+
+    /** Chebyshev coefficients per panel (degree NCOEF-1). */
+    static constexpr std::size_t NCOEF = 16;
+
+    /** Upper bound on the number of panels. */
+    static constexpr std::size_t maxPanels = 1<<12;
+
+    /** Panels are not bisected below (hi-lo)*2^-maxDepth. */
+    static constexpr int maxDepth = 64;
+
+    template<class T, class U>
+    requires std::is_arithmetic_v<T> && std::is_arithmetic_v<U>
+    disTabulated(const probDistr& distr, const T lower, const U upper, const double tolerance=1e-12) {
+        if (!(lower < upper))
+            throw std::invalid_argument("Tabulated distribution requires lower < upper.");
+        if (!(tolerance > 0))
+            throw std::invalid_argument("Tabulated distribution requires a positive tolerance.");
+        exact = distr.cloneUnique();
+        lo = lower;
+        hi = upper;
+        tol = tolerance;
+        build();
+    }
+    disTabulated() = delete;
+    ~disTabulated() = default;
+
+    /** Copy constructor: deep-copy the wrapped distribution; the tables are copied as is. */
+    disTabulated(const disTabulated& o) : exact(o.exact->cloneUnique()),
+        lo(o.lo), hi(o.hi), tol(o.tol), nPanel(o.nPanel), edges(o.edges),
+        pdfCoef(o.pdfCoef), cdfCoef(o.cdfCoef), errPdf(o.errPdf), errCdf(o.errCdf),
+        cell(o.cell), invCell(o.invCell) {}
+
+    disTabulated(disTabulated&&) = default;
+
+    double pdf(const double x) const override {
+        return inRange(x) ? interp(pdfCoef, x) : exact->pdf(x);
+    }
+
+    double cdf(const double x) const override {
+        return inRange(x) ? interp(cdfCoef, x) : exact->cdf(x);
+    }
+
+    void pdf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disTabulated::pdf(v); });
+    }
+
+    void cdf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disTabulated::cdf(v); });
+    }
+
+    /** Sampling is forwarded to the exact distribution. */
+    double draw(rngRef rng) const override {
+        return exact->draw(rng);
+    }
+
+    void draw(rngRef rng, std::span<double> r) const override {
+        exact->draw(rng, r);
+    }
+
+    double mean() const override {
+        return exact->mean();
+    }
+
+    double stddev() const override {
+        return exact->stddev();
+    }
+
+    double variance() const override {
+        return exact->variance();
+    }
+
+    double skewness() const override {
+        return exact->skewness();
+    }
+
+    inline std::size_t hash() const noexcept {
+        std::size_t seed = 0;
+        combine_hash(seed, char(id));
+        combine_hash(seed, exact->hash());
+        combine_hash(seed, lo);
+        combine_hash(seed, hi);
+        combine_hash(seed, tol);
+        return seed;
+    }
+
+    std::unique_ptr<probDistr> cloneUnique() const override {
+        return std::make_unique<disTabulated>(static_cast<disTabulated const&>(*this));
+    };
+
+    disTabulated* clone() const override {
+        return new disTabulated(*this);
+    }
+
+    pmrPtr clone(std::pmr::memory_resource* mr) const override {
+        return pmrClone(*this, mr);
+    }
+
+    void print(std::ostream& output) const override {
+        output << "Tabulated distribution -- [" << lo << ", " << hi << "] " << nPanel
+               << " panels, of: " << *exact;
+    }
+
+    bool isEqual_tol(const probDistr& o, const double tol) const override {
+        const disTabulated& oo = dynamic_cast<const disTabulated&>(o);
+        bool r = true;
+        r &= exact->getID() == oo.exact->getID() && exact->hash() == oo.exact->hash();
+        r &= isEqual_fl_tol(lo, oo.lo, tol);
+        r &= isEqual_fl_tol(hi, oo.hi, tol);
+        return r;
+    }
+
+    bool isEqual_ulp(const probDistr& o, const unsigned ulp) const override {
+        const disTabulated& oo = dynamic_cast<const disTabulated&>(o);
+        bool r = true;
+        r &= exact->getID() == oo.exact->getID() && exact->hash() == oo.exact->hash();
+        r &= isEqual_fl_ulp(lo, oo.lo, ulp);
+        r &= isEqual_fl_ulp(hi, oo.hi, ulp);
+        return r;
+    }
+
+    virtual dFuncID getID() const {return id;};
+    const dFuncID id = dFuncID::TABULATED_DISTR;
+
+    /** Largest absolute pdf error found while building the table. */
+    double maxErrorPdf() const noexcept {
+        return errPdf;
+    }
+
+    /** Largest absolute cdf error found while building the table. */
+    double maxErrorCdf() const noexcept {
+        return errCdf;
+    }
+
+    std::size_t panels() const noexcept {
+        return nPanel;
+    }
+
+    const probDistr& p_exact() const noexcept {
+        return *exact;
+    }
+
+    double p_lower() const noexcept {
+        return lo;
+    }
+
+    double p_upper() const noexcept {
+        return hi;
+    }
+};
+
+}   // namespace statanaly
+
+
+
+template<>
+class std::hash<statanaly::disTabulated> {
+public:
+    std::size_t operator() (const statanaly::disTabulated& d) const {
+        return d.hash();
+    }
+};
+
+#endif
@@ -39,6 +39,68 @@ public:
         return x;
     }
 
+    void pdf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disStdUniform::pdf(v); });
+    }
+
+    void cdf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disStdUniform::cdf(v); });
+    }
+
+    double logpdf(const double x) const override {
+        if (0>x || 1<x) {return -INFINITY;}
+        return 0;
+    }
+
+    double logcdf(const double x) const override {
+        return log(cdf(x));
+    }
+
+    double sf(const double x) const override {
+        if (0>x) return 1;
+        if (1<x) return 0;
+        return 1-x;
+    }
+
+    double logsf(const double x) const override {
+        return log(sf(x));
+    }
+
+    void logpdf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disStdUniform::logpdf(v); });
+    }
+
+    void logcdf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disStdUniform::logcdf(v); });
+    }
+
+    void sf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disStdUniform::sf(v); });
+    }
+
+    void logsf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disStdUniform::logsf(v); });
+    }
+
+    double quantile(const double p) const override {
+        checkProbability(p);
+        return p;
+    }
+
+    void quantile(std::span<const double> p, std::span<double> r) const override {
+        batchEval(p, r, [this](const double v){ return disStdUniform::quantile(v); });
+    }
+
+    double draw(rngRef rng) const override {
+        return toUnit(rng());
+    }
+
+    void draw(rngRef rng, std::span<double> r) const override {
+        sampleBlock(rng, r, [](std::span<const std::uint64_t> w, std::span<double> v){
+            for (std::size_t i=0; i<v.size(); ++i) {v[i] = toUnit(w[i]);}
+        });
+    }
+
     double mean() const override {
         return 0.5;
     }
@@ -71,6 +133,10 @@ public:
         return new disStdUniform(*this);
     }
 
+    pmrPtr clone(std::pmr::memory_resource* mr) const override {
+        return pmrClone(*this, mr);
+    }
+
     void print(std::ostream& output) const override {
         output << "Std Uniform distribution -- a = 0  b = 1";
     }
@@ -100,6 +166,10 @@ private:
     double a;
     double b;
 
+    // Derived from the parameters once, at construction.
+    double invWidth;    // 1/(b-a)
+    double logInvWidth; // log(invWidth)
+
 public:
     template<class T>
     requires std::is_arithmetic_v<T>
@@ -109,19 +179,83 @@ public:
         if(a == b) {
             throw std::runtime_error("Uniform distribution must have valid boundary.");
         }
+        invWidth = 1/(b-a);
+        logInvWidth = log(invWidth);
     }
     disUniform() = delete;
     ~disUniform() = default;
 
     constexpr double pdf(const double x) const override  {
         if (a>x || b<x) {return 0;}
-        return 1/(b-a);
+        return invWidth;
     }
 
     constexpr double cdf(const double x) const override {
         if (a>x) return 0;
         if (b<x) return 1;
-        return (x-a)/(b-a);
+        return (x-a)*invWidth;
+    }
+
+    void pdf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disUniform::pdf(v); });
+    }
+
+    void cdf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disUniform::cdf(v); });
+    }
+
+    double logpdf(const double x) const override {
+        if (a>x || b<x) {return -INFINITY;}
+        return logInvWidth;
+    }
+
+    double logcdf(const double x) const override {
+        return log(cdf(x));
+    }
+
+    double sf(const double x) const override {
+        if (a>x) return 1;
+        if (b<x) return 0;
+        return (b-x)*invWidth;
+    }
+
+    double logsf(const double x) const override {
+        return log(sf(x));
+    }
+
+    void logpdf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disUniform::logpdf(v); });
+    }
+
+    void logcdf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disUniform::logcdf(v); });
+    }
+
+    void sf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disUniform::sf(v); });
+    }
+
+    void logsf(std::span<const double> x, std::span<double> r) const override {
+        batchEval(x, r, [this](const double v){ return disUniform::logsf(v); });
+    }
+
+    double quantile(const double p) const override {
+        checkProbability(p);
+        return a + p*(b-a);
+    }
+
+    void quantile(std::span<const double> p, std::span<double> r) const override {
+        batchEval(p, r, [this](const double v){ return disUniform::quantile(v); });
+    }
+
+    double draw(rngRef rng) const override {
+        return a + (b-a)*toUnit(rng());
+    }
+
+    void draw(rngRef rng, std::span<double> r) const override {
+        sampleBlock(rng, r, [this](std::span<const std::uint64_t> w, std::span<double> v){
+            for (std::size_t i=0; i<v.size(); ++i) {v[i] = a + (b-a)*toUnit(w[i]);}
+        });
     }
 
     constexpr double mean() const override {
@@ -156,6 +290,10 @@ public:
         return new disUniform(*this);
     }
 
+    pmrPtr clone(std::pmr::memory_resource* mr) const override {
+        return pmrClone(*this, mr);
+    }
+
     void print(std::ostream& output) const override {
         output << "Uniform distribution -- a = " << a << "  b = " << b;
     }
@@ -178,6 +316,14 @@ public:
 
     virtual dFuncID getID() const {return id;};
     const dFuncID id = dFuncID::UNIFORM_DISTR;
+
+    double p_lower() const {
+        return a;
+    }
+
+    double p_upper() const {
+        return b;
+    }
 };
 }   // namespace statanaly
 
@@ -19,7 +19,13 @@
 #include "specialFunc.h"
 #include "fl_comparison.h"
 #include "hasher.h"
+#include "vecMath.h"
+#include "sampling.h"
+#include <algorithm>
+#include <cfloat>
 #include <memory>
+#include <memory_resource>
+#include <span>
 
 namespace statanaly {
 
@@ -40,10 +46,33 @@ enum class dFuncID {
     EXPONENTIAL_DISTR,
     ERLANG_DISTR,
     RAYLEIGH_DISTR,
+    TABULATED_DISTR,
+    EMPIRICAL_DISTR,
+    NC_CHI_DISTR,
+    NC_CHISQ_DISTR,
+    RICIAN_DISTR,
     COUNT
 };
 
 
+class probDistr;
+
+/**
+ * @brief Deleter of a distribution made in a memory resource: destroys it
+ * and gives its storage back to the resource.
+ */
+struct pmrDelete {
+    std::pmr::memory_resource* mr;
+    std::size_t size;
+    std::size_t align;
+
+    void operator()(probDistr* p) const noexcept;
+};
+
+/** A distribution owned in a memory resource, eg. from clone(mr). */
+using pmrPtr = std::unique_ptr<probDistr, pmrDelete>;
+
+
 /**
  * @brief Base class for probability distribution classes.
  * 
@@ -60,6 +89,51 @@ public:
     virtual double variance() const             = 0;
     virtual double skewness() const             = 0;
 
+    /** Log-density, log-cdf, survival function 1-cdf and its log.
+     * The defaults derive them from pdf() and cdf(); derived classes
+     * override them with forms that avoid the exp/log round trip and
+     * the cancellation in 1-cdf. */
+    virtual double logpdf(const double x) const;
+    virtual double logcdf(const double x) const;
+    virtual double sf(const double x) const;
+    virtual double logsf(const double x) const;
+
+    /** Quantile -- the inverse of cdf(). p must be in [0, 1].
+     * The default brackets the root and runs a safeguarded Newton
+     * iteration on cdf() and pdf(); derived classes override it with
+     * closed forms or specialised solvers. */
+    virtual double quantile(const double p) const;
+
+    /** Batch evaluation -- r[i] = f(x[i]) for every element of x.
+     * One virtual call per batch. r must be at least as long as x.
+     * Derived classes override these with tight non-virtual loops. */
+    virtual void pdf(std::span<const double> x, std::span<double> r) const;
+    virtual void cdf(std::span<const double> x, std::span<double> r) const;
+    virtual void logpdf(std::span<const double> x, std::span<double> r) const;
+    virtual void logcdf(std::span<const double> x, std::span<double> r) const;
+    virtual void sf(std::span<const double> x, std::span<double> r) const;
+    virtual void logsf(std::span<const double> x, std::span<double> r) const;
+    virtual void quantile(std::span<const double> p, std::span<double> r) const;
+
+    /** Random variates. Engine is any uniform random bit generator, eg.
+     * std::mt19937_64; it is passed on as an rngRef. The batch form makes
+     * one virtual call per batch. */
+    template<class Engine>
+    double sample(Engine& eng) const {
+        return draw(rngRef(eng));
+    }
+
+    template<class Engine>
+    void sample(Engine& eng, std::span<double> r) const {
+        draw(rngRef(eng), r);
+    }
+
+    /** Sampling behind sample(). The defaults use inverse transform,
+     * quantile(u); derived classes override them with direct samplers
+     * and fill batches with tight non-virtual loops. */
+    virtual double draw(rngRef rng) const;
+    virtual void draw(rngRef rng, std::span<double> r) const;
+
     virtual std::size_t hash() const noexcept {
         std::size_t seed = 0;
         combine_hash(seed, id);
@@ -69,6 +143,9 @@ public:
     virtual std::unique_ptr<probDistr> cloneUnique() const = 0;
     virtual probDistr* clone() const = 0;    // Return type can be Covariant.
 
+    /** Deep copy in mr; derived classes implement it by pmrClone(). */
+    virtual pmrPtr clone(std::pmr::memory_resource* mr) const = 0;
+
     // Virtual friend idiom -- The friendship will get pass down to derived classes.
     friend std::ostream& operator << (std::ostream&, const probDistr&);
     virtual void print(std::ostream&) const = 0;
@@ -89,6 +166,112 @@ protected:
 
 std::ostream& operator << (std::ostream& output, const probDistr& distr);
 
+inline void pmrDelete::operator()(probDistr* p) const noexcept {
+    p->~probDistr();
+    mr->deallocate(p, size, align);
+}
+
+/**
+ * @brief Copy d into mr.
+ * 
+ * Construction is uses-allocator construction: a distribution that takes
+ * an allocator, eg. disMixture, puts its own storage in mr as well.
+ */
+template<class T>
+pmrPtr pmrClone(const T& d, std::pmr::memory_resource* mr) {
+    std::pmr::polymorphic_allocator<> a(mr);
+    return pmrPtr(a.new_object<T>(d), pmrDelete{mr, sizeof(T), alignof(T)});
+}
+
+
+/**
+ * @brief Apply a scalar kernel to every element of a batch.
+ * 
+ * The kernel is a template parameter, so the loop is free of virtual calls
+ * and can be inlined by the derived classes' batch overrides.
+ * 
+ * @param x Input batch.
+ * @param r Output batch. Must be at least as long as x.
+ * @param f Scalar kernel.
+ */
+template<class F>
+inline void batchEval(std::span<const double> x, std::span<double> r, F&& f) {
+    if (r.size() < x.size())
+        throw std::invalid_argument("Batch output must be at least as long as batch input.");
+    for (std::size_t i=0; i<x.size(); ++i) {
+        r[i] = f(x[i]);
+    }
+}
+
+/**
+ * @brief Reject a probability outside [0, 1] (or NaN).
+ */
+inline void checkProbability(const double p) {
+    if (!(p >= 0 && p <= 1))
+        throw std::invalid_argument("Probability must be in [0, 1].");
+}
+
+
+/**
+ * @brief Solve cdf(x) = p inside a bracket.
+ * 
+ * Newton's method on cdf with pdf as the derivative. A step that leaves
+ * the bracket, or a vanishing pdf, falls back to bisection, so the
+ * iteration always converges.
+ * 
+ * @param p Target probability.
+ * @param lo Lower end of the bracket, cdf(lo) <= p.
+ * @param hi Upper end of the bracket, cdf(hi) >= p.
+ * @param x Starting point inside the bracket.
+ * @param cdf Cumulative distribution function.
+ * @param pdf Its derivative.
+ */
+template<class C, class D>
+double solveQuantile(const double p, double lo, double hi, double x, C&& cdf, D&& pdf) {
+    if (!(lo < x && x < hi)) x = 0.5*(lo + hi);
+    for (int i = 0; i < 200; ++i) {
+        const double f = cdf(x) - p;
+        if (f == 0) return x;
+        if (f < 0) lo = x;
+        else       hi = x;
+
+        const double d = pdf(x);
+        double xn = x - f/d;
+        if (!(d > 0) || !(lo < xn && xn < hi)) xn = 0.5*(lo + hi);
+        if (std::abs(xn - x) <= 4*DBL_EPSILON*std::abs(xn) || hi - lo <= 4*DBL_EPSILON*std::abs(xn))
+            return xn;
+        x = xn;
+    }
+    return x;
+}
+
+
+/**
+ * @brief Apply a block kernel to a batch, one stack buffer at a time.
+ * 
+ * Used by batch overrides built on the vectorized math functions (vecMath.h).
+ * The kernel fills the buffer b from the input block xs; since the output is
+ * only written afterwards, the kernel may read xs at any point even when r
+ * aliases x.
+ * 
+ * @param x Input batch.
+ * @param r Output batch. Must be at least as long as x.
+ * @param f Block kernel, called as f(std::span<const double> xs, std::span<double> b).
+ */
+template<class F>
+inline void batchEvalBlock(std::span<const double> x, std::span<double> r, F&& f) {
+    if (r.size() < x.size())
+        throw std::invalid_argument("Batch output must be at least as long as batch input.");
+    constexpr std::size_t BLOCK = 256;
+    double buf[BLOCK];
+    for (std::size_t i=0; i<x.size(); i+=BLOCK) {
+        const std::size_t n = std::min(BLOCK, x.size()-i);
+        const std::span<double> b(buf, n);
+        f(x.subspan(i, n), b);
+        std::copy(b.begin(), b.end(), r.begin()+i);
+    }
+}
+
 }
 
 #endif
\ No newline at end of file
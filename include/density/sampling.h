@@ -0,0 +1,198 @@
+/*
+   Copyright 2022, Ansel Blumers
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef STATANALY_SAMPLING_H_
+#define STATANALY_SAMPLING_H_
+
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <type_traits>
+
+namespace statanaly {
+
+/**
+ * @brief Type-erased reference to a uniform random bit generator.
+ * 
+ * Lets the virtual sampling functions of probDistr take any engine
+ * (std::mt19937, std::mt19937_64, ...) without being templates. It yields
+ * full-range 64-bit words: engines with a 32-bit range are called twice
+ * per word, other ranges go through std::uniform_int_distribution.
+ * fill() costs one indirect call per block instead of one per word, and
+ * hands the whole block to engines that have a fill(std::span) of their own.
+ * 
+ * It only refers to the engine, which must outlive it. rngRef is itself a
+ * uniform random bit generator, so it can drive the std:: distributions.
+ */
+class rngRef {
+public:
+    using result_type = std::uint64_t;
+
+    template<class E>
+    requires std::uniform_random_bit_generator<E> && (!std::is_same_v<std::remove_cv_t<E>, rngRef>)
+    rngRef(E& eng) noexcept : eng(&eng), fillFn(&fillWords<E>) {}
+
+    static constexpr result_type min() noexcept {return 0;}
+    static constexpr result_type max() noexcept {return UINT64_MAX;}
+
+    result_type operator()() {
+        result_type w;
+        fillFn(eng, &w, 1);
+        return w;
+    }
+
+    /** Fill w with independent words. */
+    void fill(std::span<result_type> w) {
+        fillFn(eng, w.data(), w.size());
+    }
+
+private:
+    void* eng;
+    void (*fillFn)(void*, result_type*, std::size_t);
+
+    template<class E>
+    static void fillWords(void* p, result_type* w, const std::size_t n) {
+        E& e = *static_cast<E*>(p);
+        constexpr auto range = E::max() - E::min();
+        if constexpr (E::min() == 0 && range == UINT64_MAX
+                      && requires { e.fill(std::span<result_type>(w, n)); }) {
+            e.fill(std::span<result_type>(w, n));
+            return;
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            if constexpr (range == UINT64_MAX) {
+                w[i] = static_cast<result_type>(e() - E::min());
+            } else if constexpr (range == UINT32_MAX) {
+                const result_type hi = static_cast<result_type>(e() - E::min());
+                w[i] = (hi << 32) | static_cast<result_type>(e() - E::min());
+            } else {
+                w[i] = std::uniform_int_distribution<result_type>()(e);
+            }
+        }
+    }
+};
+
+
+/** @brief Uniform double on [0, 1) from the top 53 bits of a word. */
+inline double toUnit(const std::uint64_t w) noexcept {
+    return static_cast<double>(w >> 11) * 0x1.0p-53;
+}
+
+/** @brief Uniform double on (0, 1) -- the midpoints of 2^52 cells -- safe for log(). */
+inline double toOpenUnit(const std::uint64_t w) noexcept {
+    return (static_cast<double>(w >> 12) + 0.5) * 0x1.0p-52;
+}
+
+
+/**
+ * @brief Fill a batch from blocks of random words.
+ * 
+ * Words are drawn 256 at a time into a stack buffer; the kernel maps
+ * them to variates, one per word.
+ * 
+ * @param rng Random bit generator.
+ * @param r Output batch.
+ * @param f Block kernel, called as f(std::span<const std::uint64_t> w, std::span<double> b).
+ */
+template<class F>
+inline void sampleBlock(rngRef rng, std::span<double> r, F&& f) {
+    constexpr std::size_t B = 256;
+    std::uint64_t w[B];
+    for (std::size_t s = 0; s < r.size(); s += B) {
+        const std::size_t m = std::min(B, r.size() - s);
+        rng.fill(std::span<std::uint64_t>(w, m));
+        f(std::span<const std::uint64_t>(w, m), r.subspan(s, m));
+    }
+}
+
+
+/** @brief Layers of the ziggurat tables of stdNormal() and stdExponential(). */
+inline constexpr int zigguratLayers = 256;
+
+/**
+ * @brief Standard normal variate.
+ * 
+ * Ziggurat method (Marsaglia & Tsang, 2000) on zigguratLayers layers: one
+ * word gives the layer, the sign and the abscissa, and ~99% of draws end
+ * there with one multiply and one compare. The rest take the wedge test
+ * or Marsaglia's exact tail beyond r = 3.654.
+ */
+double stdNormal(rngRef rng);
+
+/**
+ * @brief Fill r with standard normal variates.
+ * 
+ * The ziggurat over blocks of words: a branch-free pass over the block,
+ * then the few draws outside the layers' cores are finished one by one.
+ */
+void stdNormal(rngRef rng, std::span<double> r);
+
+/**
+ * @brief Standard exponential variate, by the ziggurat method.
+ * 
+ * Same layout as stdNormal(); the tail beyond r = 7.697 is r plus a fresh
+ * exponential.
+ */
+double stdExponential(rngRef rng);
+void stdExponential(rngRef rng, std::span<double> r);
+
+/**
+ * @brief Gamma(alpha, 1) variate, alpha > 0.
+ * 
+ * Marsaglia & Tsang, "A simple method for generating gamma variables"
+ * (2000): one normal and one uniform per candidate, accepted ~96-99% of
+ * the time, mostly by a squeeze without a log. alpha < 1 is boosted as
+ * Gamma(alpha+1) * U^(1/alpha).
+ */
+double stdGamma(rngRef rng, double alpha);
+
+/**
+ * @brief Fill r with Gamma(alpha, 1) variates.
+ * 
+ * Candidates for a block come from one batch of normals and one of
+ * words; the boost factors share one vecLog and vecExp per block.
+ */
+void stdGamma(rngRef rng, double alpha, std::span<double> r);
+
+/**
+ * @brief Erlang(k, 1) variate, the sum of k standard exponentials.
+ * 
+ * -log of a product of k uniforms for k <= erlangProductMaxK, which costs
+ * one log per variate; Gamma(k) above.
+ */
+double stdErlang(rngRef rng, unsigned k);
+void stdErlang(rngRef rng, unsigned k, std::span<double> r);
+
+/** @brief Largest shape that stdErlang() draws as a product of uniforms. */
+inline constexpr unsigned erlangProductMaxK = 3;
+
+/**
+ * @brief Chi-squared variate with k degrees of freedom.
+ * 
+ * A squared normal for k = 1, 2*Erlang(k/2) for even k, 2*Gamma(k/2) otherwise.
+ */
+double stdChiSq(rngRef rng, unsigned k);
+void stdChiSq(rngRef rng, unsigned k, std::span<double> r);
+
+/**
+ * @brief Poisson variate with mean lambda >= 0, returned as a double.
+ */
+double stdPoisson(rngRef rng, double lambda);
+
+}   // namespace statanaly
+
+#endif
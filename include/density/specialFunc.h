@@ -21,6 +21,7 @@
 #include <cstdint>
 #include <cmath>
 #include <cstdio>
+#include <span>
 #include <stdexcept>
 
 namespace statanaly {
@@ -123,9 +124,81 @@ static_assert(uint64_t(std::exp(logGamma(19.L))) > 6402373705727980);
 
 static_assert(std::erf(2.0) < 0.996);
 
+/**
+ * @brief Logarithm of the complementary error function.
+ * 
+ * Stays finite far beyond where erfc(x) underflows (x > 26),
+ * using the continued fraction of erfc for large x.
+ * 
+ * @param x 
+ * @return double log(erfc(x))
+ */
+double logErfc(double x);
+
+/**
+ * @brief Logarithm of the modified Bessel function of the first kind.
+ * 
+ * Stays finite where std::cyl_bessel_i overflows (z > 713) or underflows
+ * (large v, small z). Beyond z = 500 it takes Hankel's large-z series of
+ * I_v(z) e^-z when v^2/2z is moderate, else Debye's uniform expansion in v.
+ * Source:
+ *      - DLMF 10.40.1 and 10.41.3.
+ * 
+ * @param v Order, v >= 0.
+ * @param z Argument, z >= 0.
+ * @return double log(I_v(z))
+ */
+double logBesselI(double v, double z);
+
+/**
+ * @brief log(1 - exp(-a)) for a >= 0, without cancellation.
+ * 
+ * Source:
+ *      - M. Maechler, Accurately Computing log(1 - exp(-|a|)), 2012.
+ */
+inline double log1mexp(const double a) {
+    return a <= M_LN2 ? std::log(-std::expm1(-a)) : std::log1p(-std::exp(-a));
+}
+
+
+
+/**
+ * @brief Error of Stirling's formula, log(k!) - log(sqrt(2 pi k) (k/e)^k).
+ * 
+ * Tabulated at half-integers up to 15, an asymptotic series above.
+ * Together with bd0() it evaluates densities with factorials of huge k
+ * without forming the factorials.
+ * 
+ * Source:
+ *      - C. Loader, Fast and Accurate Computation of Binomial Probabilities, 2000.
+ * 
+ * @param k Real, k > 0.
+ */
+double stirlerr(double k);
 
+/**
+ * @brief Deviance term k log(k/np) + np - k.
+ * 
+ * Summed as a series, free of cancellation, when k is close to np.
+ * 
+ * @see stirlerr()
+ */
+double bd0(double k, double np);
 
-#define STATANALY_GAMMA_EPS 1e-14
+/**
+ * @brief Poisson term lambda^k e^-lambda / Gamma(k+1), for real k >= 0.
+ * 
+ * Equivalently the Gamma(k+1) density at lambda. In Loader's form
+ * exp(-stirlerr(k) - bd0(k, lambda)) / sqrt(2 pi k) for k >= 1, which
+ * stays accurate and finite for k in the millions.
+ * 
+ * @see stirlerr()
+ */
+double poissonTerm(double k, double lambda);
+
+
+
+#define STATANALY_GAMMA_EPS 3e-16
 #define STATANALY_GAMMA_TINY 1e-290
 
 /** @brief Internal implementation to Regularized Lower Gamma function.
@@ -138,16 +211,7 @@ static_assert(std::erf(2.0) < 0.996);
  * 
  * @see regLowerGamma()
  */
-inline double _regLowerGamma(double s, double z) {
-    double sum = 1, x = 1;
-    for (int k = 1; k < 100; ++k) {
-        x *= z / (s+k);
-        sum += x;
-		if (x/sum < STATANALY_GAMMA_EPS)
-            break;
-    }
-    return exp(s * log(z) - z - logGamma(s+1.) + log(sum));
-}
+double _regLowerGamma(double s, double z);
 
 
 /** @brief Internal implementation to Regularized Upper Gamma function.
@@ -158,36 +222,23 @@ inline double _regLowerGamma(double s, double z) {
  * 
  * @see regUpperGamma()
  */
-inline double _regUpperGamma(double s, double z) {
-    double f = 1. + z - s;
-    double C = f, D = 0;
-    
-    // Modified Lentz's algorithm to simplify the infinite fraction.
-    for (int j = 1; j < 100; j++) {
-        double a = j * (s - j);
-        double b = (j<<1) + 1 + z - s;
-        double d;
-		D = b + a * D;
-		if (D < STATANALY_GAMMA_TINY) 
-            D = STATANALY_GAMMA_TINY;
-		C = b + a / C;
-		if (C < STATANALY_GAMMA_TINY) 
-            C = STATANALY_GAMMA_TINY;
-		D = 1. / D;
-		d = C * D;
-		f *= d;
-		if (fabs(d - 1.) < STATANALY_GAMMA_EPS) 
-            break;
-    }
-
-    return exp(s * log(z) - z - logGamma(s) - log(f));
-}
+double _regUpperGamma(double s, double z);
 
 /**
  * @brief Regularized Lower Gamma function.
  * 
+ * The series and the continued fraction converge in O(sqrt(s)) steps,
+ * and their iteration cap grows accordingly. For s >= 20 and z within
+ * 40% of s, where both are slowest, Temme's uniform asymptotic
+ * expansion is used instead. The prefactor z^s e^-z / Gamma(s+1) is
+ * formed without cancellation for large s (Loader's saddle point form).
+ * Source:
+ *      - N. M. Temme, The asymptotic expansion of the incomplete gamma
+ *        functions, SIAM J. Math. Anal. 10, 1979.
+ *      - DLMF 8.12.
+ * 
  * @param s Upper bound of the integral.
- * @param z Power.
+ * @param z Power. 0 for z <= 0.
  * @return double 
  */
 double regLowerGamma(double s, double z);
@@ -196,11 +247,52 @@ double regLowerGamma(double s, double z);
  * @brief Regulared Upper Gamma Function.
  * 
  * @param s Lower bound of the integral.
- * @param z Power.
+ * @param z Power. 1 for z <= 0.
  * @return double 
+ * @see regLowerGamma()
  */
 double regUpperGamma(double s, double z);
 
+/**
+ * @brief Regularized Lower and Upper Gamma functions over a batch of z.
+ * 
+ * What depends on s alone (Stirling term, iteration cap) is set up once.
+ * r may alias z.
+ * 
+ * @param s Shape, shared by the batch.
+ * @param z 
+ * @param r Output; at least as long as z.
+ */
+void regLowerGamma(double s, std::span<const double> z, std::span<double> r);
+void regUpperGamma(double s, std::span<const double> z, std::span<double> r);
+
+
+/**
+ * @brief Inverse of the Regularized Lower Gamma function in z.
+ * 
+ * Solve regLowerGamma(s, z) = p for z with Halley's method,
+ * started from the Wilson-Hilferty approximation (s > 1) or the
+ * small-z power law (s <= 1).
+ * Source:
+ *      - Numerical Recipes, 3rd Ed, section 6.2.1
+ * 
+ * @param s Shape. Must be positive.
+ * @param p Probability in [0, 1].
+ * @return double z; +inf for p = 1.
+ */
+double invRegLowerGamma(double s, double p);
+
+/**
+ * @brief Inverse of the standard Normal cdf.
+ * 
+ * Acklam's rational approximation (relative error 1.15e-9),
+ * refined by one Halley step on erfc.
+ * 
+ * @param p Probability in [0, 1].
+ * @return double Quantile; -inf/+inf for p = 0/1.
+ */
+double invNormalCdf(double p);
+
 
 /**
  * @brief Upper Gamma function.
@@ -226,65 +318,113 @@ double upperGamma(double s, double z);
 double lowerGamma(double s, double z);
 
 
+/** @brief Internal implementation to Marcum Q-Function.
+ * 
+ * Q_m(a,b) is the Poisson(a^2/2) mixture of regularized upper gamma
+ * functions Q(m+k, b^2/2). The sum starts at its dominant term and
+ * moves outward until the remaining weight is negligible. Only one
+ * incomplete gamma function is evaluated; the others follow from
+ *      P(s+1,x) = P(s,x) - x^s e^-x / Gamma(s+1),
+ * run in the direction where it adds positive terms (up for Q, down for P).
+ * The smaller of P and Q is summed, so both keep full relative accuracy.
+ * Source:
+ *      - A. Gil, J. Segura, N. M. Temme, Computation of the Marcum
+ *        Q-function, ACM TOMS 40(3), 2014, section 3.
+ *      - C. Loader, Fast and Accurate Computation of Binomial
+ *        Probabilities, 2000 (for the Poisson terms).
+ * 
+ * @param complement Return P_m(a,b) = 1 - Q_m(a,b) instead.
+ * @see marcumQ(), marcumP()
+ */
+double _marcumQ(double m, double a, double b, bool complement);
+
+/** @brief Internal implementation to Marcum Q-Function, from lambda = a^2/2 and x = b^2/2.
+ * 
+ * Saves the rounding of sqrt() and squaring for callers that start from
+ * the squares, eg. the non-central chi-square distribution.
+ * The batch overload runs over x and may write in place.
+ * 
+ * @see _marcumQ()
+ */
+double _marcumQHalfSq(double m, double lambda, double x, bool complement);
+void _marcumQHalfSq(double m, double lambda, std::span<const double> x, std::span<double> r, bool complement);
+
+
 /**
  * @brief Marcum Q-Function (Integeral Order)
  * 
- * Sum up ~100 terms for the series form.
  * Integeral argument must be positive by definition.
  * 
  * @param m Order. Must be Integer.
  * @param a 
  * @param b 
  * @return double 
+ * @see _marcumQ()
  */
 template<class T, class U>
 requires std::is_arithmetic_v<T> && std::is_arithmetic_v<U>
 double marcumQ(const int m, const T a, const U b) {
-    // M must be positive by definition
-    if (m<0) throw std::invalid_argument("Marcum Q's order M must be positive.");
-
-    const double p = double(a)*b;
-    const double s = double(a)/b;
-    double t = pow(s,1-m);
-    double sum = 0;
-    for(int k=1-m; k<100-m; k++) {
-        sum += t * std::cyl_bessel_i(abs(k),p);
-        t *= s;
-    }
-    return exp(-0.5*(a*a+b*b)) * sum;
+    return _marcumQ(m, a, b, false);
 }
 
 
 /**
  * @brief Marcum Q-Function (Decimal Order)
  * 
- * Sum up ~100 terms for the series form.
  * Integeral argument must be positive by definition.
  * 
  * @param m Order. Must be Decimal.
  * @param a 
  * @param b 
  * @return double 
+ * @see _marcumQ()
  */
 template<class T, class U, class V>
 requires std::is_arithmetic_v<T> && std::is_arithmetic_v<U> && std::is_floating_point_v<V>
 double marcumQ(const V m, const T a, const U b) {
-    // M must be positive by definition
-    if (m<0) throw std::invalid_argument("Marcum Q's order M must be positive.");
-
-    const double aa = a*a;
-    const double bb = b*b;
-    double t = 1.;
-    double f = 1.;   // factorial
-    double sum = 0;
-    for(std::size_t k=0; k<100; k++) {
-        sum += t / f * regLowerGamma(m+k,0.5*bb);
-        t *= 0.5*aa;
-        f *= k+1;
-    }
-    return 1. - exp(-0.5*aa) * sum;
+    return _marcumQ(m, a, b, false);
+}
+
+
+/**
+ * @brief Complementary Marcum Q-Function, 1 - Q_m(a,b).
+ * 
+ * Accurate where Q_m(a,b) is close to 1, eg. the left tail of
+ * the non-central chi-square cdf.
+ * 
+ * @param m Order.
+ * @param a 
+ * @param b 
+ * @return double 
+ * @see _marcumQ()
+ */
+template<class T, class U, class V>
+requires std::is_arithmetic_v<T> && std::is_arithmetic_v<U> && std::is_arithmetic_v<V>
+double marcumP(const V m, const T a, const U b) {
+    return _marcumQ(m, a, b, true);
 }
 
+
+/**
+ * @brief Marcum Q-Function over a batch of b.
+ * 
+ * The Poisson weights, which only depend on a, are set up once.
+ * r may alias b.
+ * 
+ * @param m Order.
+ * @param a 
+ * @param b 
+ * @param r Output; at least as long as b.
+ */
+void marcumQ(double m, double a, std::span<const double> b, std::span<double> r);
+
+/**
+ * @brief Complementary Marcum Q-Function over a batch of b.
+ * 
+ * @see marcumQ(double, double, std::span<const double>, std::span<double>)
+ */
+void marcumP(double m, double a, std::span<const double> b, std::span<double> r);
+
 } // namespace stantanaly
 
 #endif
\ No newline at end of file
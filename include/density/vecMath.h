@@ -0,0 +1,81 @@
+/*
+   Copyright 2022, Ansel Blumers
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef STATANALY_VEC_MATH_H_
+#define STATANALY_VEC_MATH_H_
+
+#include <cstdint>
+#include <span>
+
+namespace statanaly {
+
+/** @brief Instruction sets of the vectorized math kernels, narrowest first. */
+enum class simdISA {
+    SCALAR,
+    SSE2,
+    AVX2,       // with FMA
+    AVX512,     // AVX-512F
+};
+
+/** @brief Widest instruction set that is both compiled in and supported by this CPU. */
+simdISA simdSupported() noexcept;
+
+/** @brief Instruction set currently used by the vec* functions. */
+simdISA simdActive() noexcept;
+
+/** @brief Force an instruction set; it is clamped to simdSupported().
+ *  Returns the instruction set that is now active. Meant for testing and benchmarking. */
+simdISA simdSelect(simdISA isa) noexcept;
+
+
+/* Vectorized elementwise math ------------------------
+ *
+ * r[i] = f(x[i]) for i < x.size(). The result agrees with libm to a few ulp;
+ * special values (NaN, Inf, subnormals, overflow) are delegated to libm.
+ * r may alias x. Throws std::invalid_argument if r is shorter than x.
+ * The float overloads are evaluated in double precision.
+ */
+
+void vecExp (std::span<const double> x, std::span<double> r);
+void vecLog (std::span<const double> x, std::span<double> r);
+void vecErf (std::span<const double> x, std::span<double> r);
+void vecErfc(std::span<const double> x, std::span<double> r);
+void vecAtan(std::span<const double> x, std::span<double> r);
+
+void vecExp (std::span<const float> x, std::span<float> r);
+void vecLog (std::span<const float> x, std::span<float> r);
+void vecErf (std::span<const float> x, std::span<float> r);
+void vecErfc(std::span<const float> x, std::span<float> r);
+void vecAtan(std::span<const float> x, std::span<float> r);
+
+/** @brief r[i] = pow(x[i], y[i]). Throws if y or r is shorter than x. */
+void vecPow(std::span<const double> x, std::span<const double> y, std::span<double> r);
+
+/** @brief r[i] = pow(x[i], y). */
+void vecPow(std::span<const double> x, const double y, std::span<double> r);
+
+
+/* Counter-based random bits --------------------------
+ *
+ * Philox4x32-10 (Salmon et al., SC'11). Block b of a stream is the 128-bit
+ * counter (b, stream) encrypted under key; r[2j] and r[2j+1] are the low
+ * and high 64-bit words of block first+j. The lanes of one register hold
+ * consecutive blocks. Throws std::invalid_argument if r.size() is odd.
+ */
+void vecPhilox(std::uint64_t key, std::uint64_t stream, std::uint64_t first, std::span<std::uint64_t> r);
+
+}   // namespace statanaly
+
+#endif
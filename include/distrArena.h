@@ -0,0 +1,105 @@
+/*
+   Copyright 2022, Ansel Blumers
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef STATANALY_DISTR_ARENA_H_
+#define STATANALY_DISTR_ARENA_H_
+
+#include "density/probDistr.h"
+#include <memory_resource>
+#include <vector>
+
+namespace statanaly {
+
+
+/**
+ * @brief Distributions made in bulk and released in one shot.
+ *
+ * A monotonic buffer: make() costs a pointer bump, with no lock and no
+ * call to the global allocator once the buffer has grown; the list of
+ * what was made lives in the buffer too. release()
+ * destroys every distribution made so far and frees their storage at
+ * once; nothing made here is deleted on its own.
+ *
+ * An arena is not thread-safe. Give each worker thread its own.
+ *
+ * Under an arenaScope, the results of cnvl, cnvlSq, cnvlSSqrt, the
+ * convolve functions and the Monte Carlo convolutions are made in the
+ * arena of the calling thread instead of by new.
+ */
+class distrArena {
+private:
+    std::pmr::monotonic_buffer_resource buf;
+    std::pmr::vector<probDistr*> made{&buf};
+
+public:
+    /** @param initialSize bytes of the first buffer taken from upstream. */
+    explicit distrArena(const std::size_t initialSize = 1<<16,
+                        std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+    ~distrArena();
+
+    distrArena(const distrArena&) = delete;
+    distrArena& operator=(const distrArena&) = delete;
+
+    /** For containers and clone(mr); objects put there are not tracked by release(). */
+    std::pmr::memory_resource* resource() noexcept {
+        return &buf;
+    }
+
+    /** A T made in the arena, destroyed by release(). */
+    template<class T, class... Args>
+    T* make(Args&&... args) {
+        made.push_back(nullptr);    // room first, so a T is never left untracked
+        try {
+            T* p = std::pmr::polymorphic_allocator<>(&buf).new_object<T>(std::forward<Args>(args)...);
+            made.back() = p;
+            return p;
+        } catch (...) {
+            made.pop_back();
+            throw;
+        }
+    }
+
+    /** Distributions made since the last release(). */
+    std::size_t size() const noexcept {
+        return made.size();
+    }
+
+    /** Destroy every distribution made here and free the buffer. */
+    void release() noexcept;
+
+    /** The arena of the innermost arenaScope on this thread, or nullptr. */
+    static distrArena* current() noexcept;
+};
+
+
+/**
+ * @brief Makes a distrArena the calling thread's current() one, for the
+ * lifetime of the scope. Scopes nest.
+ */
+class arenaScope {
+private:
+    distrArena* prev;
+
+public:
+    explicit arenaScope(distrArena& arena);
+    ~arenaScope();
+
+    arenaScope(const arenaScope&) = delete;
+    arenaScope& operator=(const arenaScope&) = delete;
+};
+
+}   // namespace statanaly
+
+#endif
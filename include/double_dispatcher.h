@@ -17,6 +17,7 @@
 #define STATANALY_D_DOUBLE_DISPATCHER_H_
 
 #include "type_info.h"
+#include <functional>
 #include <map>
 
 
@@ -43,6 +44,8 @@ class BasicDispatcher {
 	typedef std::map<KeyType, MappedType> MapType;
 
 public:
+	typedef std::function<ResultType(BaseLhs&, BaseRhs&)> FallbackType;
+
 	template <class SomeLhs, class SomeRhs>
 	void add(CallbackType fun) {
 		const KeyType key(typeid(SomeLhs), typeid(SomeRhs));
@@ -54,14 +57,21 @@ public:
 		const KeyType key(typeid(lhs), typeid(rhs));
 		auto i = callbackMap_.find(KeyType(typeid(lhs), typeid(rhs)));
 		if (i == callbackMap_.end()) {
+			if (fallback_) return fallback_(lhs, rhs);
 			throw std::runtime_error("Function not found");
 		}
 
 		return (i->second)(lhs, rhs);
 	}
 
+	/* Called by go() for a pair without a registered callback. Empty to throw instead. */
+	void setFallback(FallbackType fun) {
+		fallback_ = std::move(fun);
+	}
+
 private:
 	MapType callbackMap_;
+	FallbackType fallback_;
 };
 
 
@@ -115,6 +125,18 @@ public:
 	ResultType go(BaseLhs& lhs, BaseRhs& rhs) {
 		return backEnd_.go(lhs,rhs);
 	}
+
+	/**
+	 * @brief Handle every pair without a registered callback with fun,
+	 * instead of throwing "Function not found".
+	 */
+	void setFallback(typename BasicDispatcher<BaseLhs, BaseRhs, ResultType>::FallbackType fun) {
+		backEnd_.setFallback(std::move(fun));
+	}
+
+	void clearFallback() {
+		backEnd_.setFallback(nullptr);
+	}
 };
 
 }   // namespace statanaly
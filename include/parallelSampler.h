@@ -0,0 +1,130 @@
+/*
+   Copyright 2022, Ansel Blumers
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef STATANALY_PARALLEL_SAMPLER_H_
+#define STATANALY_PARALLEL_SAMPLER_H_
+
+#include "density/probDistr.h"
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <semaphore>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace statanaly {
+
+
+/**
+ * @brief Draws of one distribution into a caller's buffer.
+ */
+struct sampleJob {
+    const probDistr* distr;
+    std::span<double> out;
+};
+
+
+/**
+ * @brief Fill buffers with draws, on a pool of threads.
+ *
+ * A run is cut into chunks of chunkSize draws. Chunk c of job j is drawn
+ * from rng_philox(seed, j<<32 | c), and chunk c always covers
+ * out[c*chunkSize, (c+1)*chunkSize). So the output depends on the seed and
+ * the jobs only, never on the number of threads or which one ran a chunk.
+ *
+ * Every thread starts with a contiguous share of the chunks. It takes its
+ * own from the front; when it runs out, it steals the back half of the
+ * largest share left. A slow distribution (eg. disNcChiSq, one Poisson
+ * and one Gamma per draw) next to fast ones therefore does not leave
+ * threads idle.
+ *
+ * The calling thread works as one of the threads; the others persist
+ * between runs. Concurrent calls to run() are serialised.
+ */
+class parallelSampler {
+private:
+
+    struct chunk {
+        std::size_t job;
+        std::size_t first;
+        std::size_t count;
+    };
+
+    // The chunks [lo, hi) that worker i has yet to run.
+    struct share {
+        std::mutex m;
+        std::size_t lo = 0;
+        std::size_t hi = 0;
+    };
+
+    struct worker {
+        std::binary_semaphore go{0};
+        std::thread th;
+    };
+
+    std::vector<share> shares;
+    std::vector<std::unique_ptr<worker>> pool;   // threads()-1 of them
+    std::counting_semaphore<> done{0};
+    std::mutex running;
+    bool stop = false;
+
+    // The run in progress.
+    std::span<const sampleJob> jobs;
+    std::vector<chunk> chunks;
+    std::uint64_t key = 0;
+    std::atomic<bool> failed{false};
+    std::exception_ptr err;
+    std::mutex errLock;
+
+    bool pop(const std::size_t i, std::size_t& c);
+    bool steal(const std::size_t i);
+    void work(const std::size_t i);
+
+public:
+
+    /** Draws per chunk. */
+    static constexpr std::size_t chunkSize = 1<<14;
+
+    /** @param threads 0 for std::thread::hardware_concurrency(). */
+    explicit parallelSampler(const unsigned threads=0);
+    ~parallelSampler();
+
+    parallelSampler(const parallelSampler&) = delete;
+    parallelSampler& operator=(const parallelSampler&) = delete;
+
+    unsigned threads() const noexcept {
+        return unsigned(shares.size());
+    }
+
+    /**
+     * @brief Fill every job's buffer; returns when all are full.
+     *
+     * An exception from a draw stops the run and is rethrown here; the
+     * buffers are then partly written.
+     */
+    void run(std::span<const sampleJob> jobs, const std::uint64_t seed);
+
+    void run(const probDistr& distr, std::span<double> out, const std::uint64_t seed) {
+        const sampleJob job{&distr, out};
+        run(std::span<const sampleJob>(&job, 1), seed);
+    }
+};
+
+}   // namespace statanaly
+
+#endif
@@ -0,0 +1,185 @@
+/*
+   Copyright 2022, Ansel Blumers
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+/* Quasi-Monte Carlo
+ *
+ * Low-discrepancy points in the unit cube, mapped through quantile() to
+ * estimate expectations of functions of independent random variables.
+ */
+
+#ifndef STATANALY_QMC_H_
+#define STATANALY_QMC_H_
+
+#include "density/probDistr.h"
+#include <cstdint>
+#include <initializer_list>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace statanaly {
+
+
+/**
+ * @brief Sobol sequence, optionally scrambled.
+ *
+ * Points of a digital sequence in base 2, 32 bits per coordinate, in the
+ * Gray code order of Antonov and Saleev: each point is one XOR away from
+ * the last. The first 2^m points of any dimension put exactly one point in
+ * each interval [k/2^m, (k+1)/2^m).
+ *
+ * The direction numbers come from the primitive polynomials in order of
+ * degree. The initial values of each dimension were chosen, one dimension
+ * at a time, to minimise the t-values of its two-dimensional projections
+ * with the dimensions before it (the criterion of Joe and Kuo, 2008).
+ *
+ * Scrambled (constructed with a key and stream), every dimension gets
+ * Matousek's random linear scramble and a random digital shift, drawn
+ * from rng_philox(key, stream). This keeps the equidistribution and makes
+ * each point uniform on the cube. Independent streams give independent
+ * replicates, which is where an error estimate comes from.
+ *
+ * A coordinate is the midpoint of its 2^-32 cell, so it lies in (0, 1)
+ * and is safe for quantile().
+ */
+class sobol {
+private:
+    unsigned d;
+    std::uint64_t n;                // index of the next point
+    std::vector<std::uint32_t> v;   // direction numbers, dimension j at [32j, 32j+32)
+    std::vector<std::uint32_t> x;   // the next point
+    std::vector<std::uint32_t> shift;   // digital shift, zero when unscrambled
+
+    void build();
+
+public:
+
+    /** Largest number of dimensions. */
+    static constexpr unsigned maxDim = 64;
+
+    /** Number of points before the sequence repeats. */
+    static constexpr std::uint64_t maxPoints = std::uint64_t(1) << 32;
+
+    /** The unscrambled sequence; its first point is the origin. */
+    explicit sobol(const unsigned dim);
+
+    /** A scrambled sequence. */
+    sobol(const unsigned dim, const std::uint64_t key, const std::uint64_t stream=0);
+
+    sobol() = delete;
+
+    unsigned dim() const noexcept {
+        return d;
+    }
+
+    /** Index of the next point. */
+    std::uint64_t index() const noexcept {
+        return n;
+    }
+
+    /** Jump to point i. */
+    void seek(const std::uint64_t i);
+
+    /** The next point into u, which takes dim() values. */
+    void next(std::span<double> u);
+
+    /**
+     * @brief The next count points, dimension by dimension: coordinate j
+     * of point i goes to u[j*count + i].
+     *
+     * So each dimension is a contiguous span, ready for a batch quantile().
+     */
+    void next(const std::size_t count, std::span<double> u);
+};
+
+
+/**
+ * @brief Settings of the randomized quasi-Monte Carlo estimates.
+ */
+struct qmcOptions {
+    std::size_t points = 1<<14;     // per replicate; a power of two keeps the nets complete
+    unsigned replicates = 16;       // independent scrambles, at least two
+    std::uint64_t seed = 0;         // key of the scrambles
+};
+
+/**
+ * @brief A randomized quasi-Monte Carlo estimate.
+ */
+struct qmcEstimate {
+    double value;       // mean of the replicates
+    double stdError;    // of value, from the spread of the replicates
+};
+
+
+/**
+ * @brief E[g(X1 + ... + Xn)] for independent Xi, by randomized QMC.
+ *
+ * Replicate r maps the points of sobol(n, opt.seed, r) through the batch
+ * quantile() of each Xi and averages g over their sums. The estimate is the
+ * mean of the replicates, and its standard error comes from their spread.
+ * For a smooth g the error falls almost as 1/points, against
+ * 1/sqrt(points) for plain Monte Carlo. Tail probabilities are g = 1{s > t}.
+ * The indicator is not smooth, so the gain there is smaller.
+ *
+ * @param x The distributions, at most sobol::maxDim.
+ * @param g Called as g(double), returns double.
+ */
+template<class G>
+qmcEstimate qmcExpectSum(std::span<const probDistr* const> x, G&& g, const qmcOptions& opt = {}) {
+    if (x.empty() || x.size() > sobol::maxDim)
+        throw std::invalid_argument("qmcExpectSum takes between one and sobol::maxDim distributions.");
+    if (opt.points == 0 || opt.points > sobol::maxPoints)
+        throw std::invalid_argument("qmcExpectSum requires between one and sobol::maxPoints points.");
+    if (opt.replicates < 2)
+        throw std::invalid_argument("qmcExpectSum requires at least two replicates for the error estimate.");
+
+    constexpr std::size_t B = 256;
+    const std::size_t n = x.size();
+    std::vector<double> u(B*n), q(B), s(B);
+
+    std::vector<double> est(opt.replicates);
+    for (unsigned r = 0; r < opt.replicates; ++r) {
+        sobol seq(n, opt.seed, r);
+        long double acc = 0;
+        for (std::size_t i = 0; i < opt.points; i += B) {
+            const std::size_t m = std::min(B, opt.points - i);
+            seq.next(m, u);
+            std::fill_n(s.begin(), m, 0.);
+            for (std::size_t j = 0; j < n; ++j) {
+                x[j]->quantile(std::span<const double>(u.data() + j*m, m), std::span<double>(q.data(), m));
+                for (std::size_t k = 0; k < m; ++k) {s[k] += q[k];}
+            }
+            for (std::size_t k = 0; k < m; ++k) {acc += g(s[k]);}
+        }
+        est[r] = acc / opt.points;
+    }
+
+    const double R = opt.replicates;
+    double mean = 0, var = 0;
+    for (const double e : est) {mean += e;}
+    mean /= R;
+    for (const double e : est) {var += (e-mean)*(e-mean);}
+    var /= R-1;
+    return {mean, std::sqrt(var / R)};
+}
+
+template<class G>
+qmcEstimate qmcExpectSum(std::initializer_list<const probDistr*> x, G&& g, const qmcOptions& opt = {}) {
+    return qmcExpectSum(std::span<const probDistr* const>(x.begin(), x.size()), std::forward<G>(g), opt);
+}
+
+}   // namespace statanaly
+
+#endif
@@ -32,6 +32,16 @@
 #include <random>
 #include <algorithm>
 #include <iterator>
+#include <cerrno>
+#include <atomic>
+#include <semaphore>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "density/vecMath.h"
 
 namespace statanaly {
 
@@ -43,21 +53,143 @@ namespace statanaly {
  * More "direct" than libstd.
  * Non-blocking.
  * For Unix-like OS only.
+ * 
+ * Unbuffered (default constructed), every call is one read(2) of exactly
+ * the requested bytes. Buffered (constructed with a block size), bytes are
+ * served from two blocks in user space: while one is consumed, a
+ * background thread refills the other, so only requests larger than a
+ * block reach the kernel on the caller's thread.
+ * 
+ * Short reads and EINTR are retried; other read failures throw
+ * std::runtime_error. One object must not be used by several threads at
+ * once. It is a uniform random bit generator of 64-bit words, so it can
+ * drive probDistr::sample() and the std:: distributions.
  */
 class rng_unix {
-    int fd = 0;
+    int fd = -1;
+
+    // Two blocks; block[cur] is being consumed from pos, the other one is
+    // handed to the background thread. The semaphores pass the spare block
+    // back and forth, so neither side ever touches a block the other owns.
+    struct ring {
+        std::vector<unsigned char> block[2];
+        std::size_t pos = 0;
+        int cur = 0;
+        std::binary_semaphore filled{0};    // spare block is ready
+        // Spare block may be refilled. The stop signal in release() can
+        // arrive while a refill grant is still pending, hence a count of 2.
+        std::counting_semaphore<2> empty{0};
+        std::atomic<bool> failed = false;
+        std::atomic<bool> stop = false;
+        std::thread refiller;
+    };
+    std::unique_ptr<ring> buf;
 
     void openUrandom() {
-        fd = open("/dev/urandom", O_RDONLY);
-        assert(fd>=0);
+        fd = open("/dev/urandom", O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            throw std::runtime_error("Cannot open /dev/urandom.");
+    }
+
+    /** read(2) until all n bytes arrived. */
+    static bool readFully(const int fd, void* dst, std::size_t n) noexcept {
+        auto p = static_cast<unsigned char*>(dst);
+        while (n > 0) {
+            const ssize_t got = read(fd, p, n);
+            if (got < 0 && errno == EINTR) continue;
+            if (got <= 0) return false;
+            p += got;
+            n -= static_cast<std::size_t>(got);
+        }
+        return true;
+    }
+
+    static void refill(ring* r, const int fd) {
+        while (true) {
+            r->empty.acquire();
+            if (r->stop.load()) return;
+            auto& b = r->block[1 - r->cur];
+            if (!readFully(fd, b.data(), b.size())) r->failed.store(true);
+            r->filled.release();
+        }
+    }
+
+    /** Switch to the refilled block and let the thread refill the used one. */
+    void swapBlocks() {
+        buf->filled.acquire();
+        if (buf->failed.load()) {
+            buf->filled.release();
+            throw std::runtime_error("Reading /dev/urandom failed.");
+        }
+        buf->cur = 1 - buf->cur;
+        buf->pos = 0;
+        buf->empty.release();
+    }
+
+    void copyBytes(unsigned char* dst, std::size_t n) {
+        if (!buf || n >= buf->block[0].size()) {
+            if (!readFully(fd, dst, n))
+                throw std::runtime_error("Reading /dev/urandom failed.");
+            return;
+        }
+        while (n > 0) {
+            if (buf->pos == buf->block[buf->cur].size()) swapBlocks();
+            const auto& b = buf->block[buf->cur];
+            const std::size_t take = std::min(n, b.size() - buf->pos);
+            std::memcpy(dst, b.data() + buf->pos, take);
+            buf->pos += take;
+            dst += take;
+            n -= take;
+        }
+    }
+
+    void release() noexcept {
+        if (buf) {
+            // The thread is either reading or waiting for an empty block.
+            buf->stop.store(true);
+            buf->empty.release();
+            buf->refiller.join();
+            buf.reset();
+        }
+        if (fd>=0) close(fd);
+        fd = -1;
     }
 
 public:
+    using result_type = std::uint64_t;
+
+    /** Default block size of the buffered mode, in bytes. */
+    static constexpr std::size_t defaultBlock = 1<<16;
+
+    /** Unbuffered. */
     rng_unix() {
         openUrandom();
     }
+
+    /** Buffered, with two blocks of blockBytes each. */
+    explicit rng_unix(const std::size_t blockBytes) {
+        if (blockBytes == 0)
+            throw std::invalid_argument("rng_unix block size must be positive.");
+        openUrandom();
+        try {
+            buf = std::make_unique<ring>();
+            buf->block[0].resize(blockBytes);
+            buf->block[1].resize(blockBytes);
+            if (!readFully(fd, buf->block[0].data(), blockBytes))
+                throw std::runtime_error("Reading /dev/urandom failed.");
+            buf->refiller = std::thread(&rng_unix::refill, buf.get(), fd);
+        } catch (...) {
+            // No refill thread runs yet, so release() has nothing to join.
+            buf.reset();
+            close(fd);
+            fd = -1;
+            throw;
+        }
+        buf->empty.release();
+    }
+
     ~rng_unix() {
-        if (fd>=0) close(fd);
+        release();
     }
 
     // Disable copy operations.
@@ -65,11 +197,16 @@ public:
     rng_unix& operator = (const rng_unix&) = delete;
     
     // Move operations only
-    rng_unix(rng_unix&& other) {
+    rng_unix(rng_unix&& other) noexcept {
         fd = std::exchange(other.fd, -1);
+        buf = std::move(other.buf);
     }
-    rng_unix& operator = (rng_unix&& other) {
-        fd = std::exchange(other.fd, -1);
+    rng_unix& operator = (rng_unix&& other) noexcept {
+        if (this != &other) {
+            release();
+            fd = std::exchange(other.fd, -1);
+            buf = std::move(other.buf);
+        }
         return *this;
     }
 
@@ -77,18 +214,130 @@ public:
         return fd;
     }
 
+    inline bool buffered() const noexcept {
+        return static_cast<bool>(buf);
+    }
+
+    /** Fill out with random bytes, without allocating. */
+    template<class T>
+    requires std::is_trivially_copyable_v<T>
+    void fill(std::span<T> out) {
+        copyBytes(reinterpret_cast<unsigned char*>(out.data()), out.size_bytes());
+    }
+
     template<class T>
     auto getRN() {
-        T buf;
-        read(fd, &buf, sizeof(T));
-        return buf;
+        T v;
+        fill(std::span<T>(&v, 1));
+        return v;
     }
 
     template<class T>
     auto getRN(uint num) {
-        std::unique_ptr<T[]> buf = std::make_unique<T[]>(num);
-        read(fd, buf.get(), sizeof(T)*num);
-        return buf;
+        std::unique_ptr<T[]> out = std::make_unique<T[]>(num);
+        fill(std::span<T>(out.get(), num));
+        return out;
+    }
+
+    static constexpr result_type min() noexcept {return 0;}
+    static constexpr result_type max() noexcept {return UINT64_MAX;}
+
+    result_type operator()() {
+        return getRN<result_type>();
+    }
+};
+
+
+
+/**
+ * @brief Counter-based pseudo RNG (Philox4x32-10)
+ * 
+ * Salmon et al., "Parallel random numbers: as easy as 1, 2, 3" (SC'11).
+ * Block b of stream s is the 10-round Philox bijection of the 128-bit
+ * counter (b, s) under a 64-bit key; each block gives two 64-bit words.
+ * The key and the stream id together form the 128-bit identity of a
+ * stream, so every (key, stream) pair yields its own sequence of 2^64
+ * words, disjoint from the others by construction.
+ * 
+ * There is no state to warm up: seeding, discard() and stream() are
+ * O(1). Give task i the engine stream(i) and the result does not depend
+ * on which thread ran it, or on how many threads there were.
+ * 
+ * The blocks come from vecPhilox(), which computes 2, 4 or 8 of them per
+ * instruction depending on the instruction set; single words are served
+ * from a buffer of bufWords.
+ */
+class rng_philox {
+public:
+    using result_type = std::uint64_t;
+
+    /** Words generated at a time for operator(). */
+    static constexpr std::size_t bufWords = 16;
+
+    explicit rng_philox(const std::uint64_t key=0, const std::uint64_t stream=0) {
+        seed(key, stream);
+    }
+
+    void seed(const std::uint64_t key=0, const std::uint64_t stream=0) {
+        k = key;
+        s = stream;
+        ctr = 0;
+        refill();
+    }
+
+    /** The first word of stream id of the same key. */
+    rng_philox stream(const std::uint64_t id) const {
+        return rng_philox(k, id);
+    }
+
+    std::uint64_t key() const noexcept {return k;}
+    std::uint64_t streamID() const noexcept {return s;}
+
+    /** Position, in words, within the stream. */
+    std::uint64_t position() const noexcept {return ctr;}
+
+    static constexpr result_type min() noexcept {return 0;}
+    static constexpr result_type max() noexcept {return UINT64_MAX;}
+
+    result_type operator()() {
+        const result_type w = buf[ctr % bufWords];
+        if (++ctr % bufWords == 0) refill();
+        return w;
+    }
+
+    /** Skip n words. */
+    void discard(const std::uint64_t n) {
+        ctr += n;
+        refill();
+    }
+
+    /** Fill w with the next w.size() words; the same words as w.size() calls. */
+    void fill(std::span<result_type> w) {
+        std::size_t i = 0;
+        for (; i < w.size() && ctr % bufWords != 0; ++i) {w[i] = (*this)();}
+        const std::size_t m = (w.size() - i) / bufWords * bufWords;
+        if (m > 0) {
+            vecPhilox(k, s, ctr/2, w.subspan(i, m));
+            ctr += m;
+            refill();
+            i += m;
+        }
+        for (; i < w.size(); ++i) {w[i] = (*this)();}
+    }
+
+    friend bool operator == (const rng_philox& a, const rng_philox& b) noexcept {
+        return a.k == b.k && a.s == b.s && a.ctr == b.ctr;
+    }
+
+private:
+    std::uint64_t k;        // key
+    std::uint64_t s;        // stream id, the upper half of the counter
+    std::uint64_t ctr;      // next word
+    std::uint64_t buf[bufWords];   // the bufWords-aligned group holding word ctr
+
+    void refill() {
+        const std::uint64_t first = ctr / bufWords * bufWords;
+        vecPhilox(k, s, first/2, buf);
     }
 };
 
@@ -101,7 +350,7 @@ public:
  * 
  * @param eng RN generator engine.
  */
-void setProperSeed(std::mt19937& eng) {
+inline void setProperSeed(std::mt19937& eng) {
     // use "default" token because it is portable.
     std::random_device rd;
     std::random_device::result_type rnd_nums[std::mt19937::state_size];
@@ -111,6 +360,22 @@ void setProperSeed(std::mt19937& eng) {
     eng.seed(seeds);
 };
 
+/**
+ * @brief Seed STL mt19937 RN generators from an rng_unix.
+ * 
+ * With a buffered rng_unix, seeding many engines costs no syscall per engine.
+ * 
+ * @param eng RN generator engine.
+ * @param src Source of the 624x4 seed bytes.
+ */
+inline void setProperSeed(std::mt19937& eng, rng_unix& src) {
+    std::uint32_t rnd_nums[std::mt19937::state_size];
+    src.fill(std::span<std::uint32_t>(rnd_nums));
+    std::seed_seq seeds(std::begin(rnd_nums), std::end(rnd_nums));
+
+    eng.seed(seeds);
+}
+
 
 } // namespace 
 
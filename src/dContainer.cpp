@@ -14,10 +14,325 @@
    limitations under the License.
 */
 #include <iostream>
+#include <queue>
 #include "dContainer.h"
+#include "density/disNormal.h"
+#include "density/disUniform.h"
 
 namespace statanaly {
 
+dAliasTable::dAliasTable(const dIngredients& ingreds) {
+    const std::size_t n = ingreds.size();
+    comp.reserve(n);
+    prob.resize(n);
+    alias.resize(n);
+
+    // Scaled weights n*w; "small" columns are under-full, "large" over-full.
+    // The normalized weights sum to one only up to rounding, and whatever
+    // is off ends up in the last column; so rescale them to sum to n here,
+    // in long double, as are the residuals of the large columns.
+    std::vector<long double> q;
+    q.reserve(n);
+    long double sum = 0;
+    for (const auto& [d,ws] : ingreds) {
+        comp.push_back(d);
+        q.push_back(ws.second);
+        sum += ws.second;
+    }
+    for (auto& v : q) {v *= n / sum;}
+    std::vector<std::uint32_t> small, large;
+    for (std::uint32_t i=0; i<n; ++i) {(q[i] < 1 ? small : large).push_back(i);}
+
+    while (!small.empty() && !large.empty()) {
+        const std::uint32_t s = small.back(), l = large.back();
+        small.pop_back();
+        prob[s] = q[s];
+        alias[s] = l;
+        q[l] -= 1 - q[s];
+        if (q[l] < 1) {
+            large.pop_back();
+            small.push_back(l);
+        }
+    }
+    // Whatever is left is full up to rounding.
+    for (const auto i : large) {prob[i] = 1; alias[i] = i;}
+    for (const auto i : small) {prob[i] = 1; alias[i] = i;}
+}
+
+dGroups::dGroups(const dIngredients& ingreds) {
+    for (const auto& [d,ws] : ingreds) {
+        const double w = ws.second;
+        switch (d->getID()) {
+        case dFuncID::NORMAL_DISTR: {
+            const disNormal& n = static_cast<const disNormal&>(*d);
+            normal.mu.push_back(n.p_location());
+            normal.invSig.push_back(1/n.p_scale());
+            normal.logNorm.push_back(-log(n.p_scale()) - SACV_LOG_SQRT_2PI);
+            normal.w.push_back(w);
+            break;
+        }
+        case dFuncID::UNIFORM_DISTR: {
+            const disUniform& u = static_cast<const disUniform&>(*d);
+            uniform.lo.push_back(u.p_lower());
+            uniform.hi.push_back(u.p_upper());
+            uniform.invWidth.push_back(1/(u.p_upper()-u.p_lower()));
+            uniform.w.push_back(w);
+            break;
+        }
+        case dFuncID::STD_UNIFORM_DISTR:
+            uniform.lo.push_back(0);
+            uniform.hi.push_back(1);
+            uniform.invWidth.push_back(1);
+            uniform.w.push_back(w);
+            break;
+        default:
+            other.push_back(d);
+            otherW.push_back(w);
+        }
+    }
+}
+
+namespace {
+
+enum class mixFn {pdf, cdf, sf};
+
+constexpr std::size_t groupBlock = 256;
+
+/** Argument of the vecExp (pdf) or vecErfc (cdf, sf) of Normal component i at x. */
+template<mixFn F>
+inline double normalArg(const dGroups::normalGroup& g, const std::size_t i, const double x) {
+    if constexpr (F == mixFn::pdf) {
+        const double z = (x-g.mu[i])*g.invSig[i];
+        return g.logNorm[i] - 0.5*z*z;
+    } else if constexpr (F == mixFn::cdf) {
+        return (g.mu[i]-x)*g.invSig[i] * M_SQRT1_2;
+    } else {
+        return (x-g.mu[i])*g.invSig[i] * M_SQRT1_2;
+    }
+}
+
+template<mixFn F>
+inline void normalFinish(std::span<double> b) {
+    if constexpr (F == mixFn::pdf) {
+        vecExp(b, b);
+    } else {
+        vecErfc(b, b);
+        for (double& v : b) {v *= 0.5;}
+    }
+}
+
+template<mixFn F>
+inline double uniformAt(const dGroups::uniformGroup& g, const std::size_t i, const double x) {
+    if constexpr (F == mixFn::pdf) {
+        return (g.lo[i] <= x && x <= g.hi[i]) ? g.invWidth[i] : 0.;
+    } else if constexpr (F == mixFn::cdf) {
+        return std::clamp((x-g.lo[i])*g.invWidth[i], 0., 1.);
+    } else {
+        return std::clamp((g.hi[i]-x)*g.invWidth[i], 0., 1.);
+    }
+}
+
+using scalarFn = double (probDistr::*)(const double) const;
+using batchFn = void (probDistr::*)(std::span<const double>, std::span<double>) const;
+
+template<mixFn F>
+double groupsAt(const dGroups& g, const double x, scalarFn f) {
+    double s = 0;
+
+    const std::size_t nn = g.normal.w.size();
+    double b[groupBlock];
+    for (std::size_t k = 0; k < nn; k += groupBlock) {
+        const std::size_t m = std::min(groupBlock, nn - k);
+        for (std::size_t i = 0; i < m; ++i) {b[i] = normalArg<F>(g.normal, k+i, x);}
+        normalFinish<F>(std::span<double>(b, m));
+        for (std::size_t i = 0; i < m; ++i) {s += g.normal.w[k+i] * b[i];}
+    }
+
+    for (std::size_t i = 0; i < g.uniform.w.size(); ++i) {s += g.uniform.w[i] * uniformAt<F>(g.uniform, i, x);}
+
+    for (std::size_t i = 0; i < g.other.size(); ++i) {s += (g.other[i]->*f)(x) * g.otherW[i];}
+    return s;
+}
+
+template<mixFn F>
+void groupsAt(const dGroups& g, std::span<const double> x, std::span<double> r, batchFn f) {
+    if (r.size() < x.size())
+        throw std::invalid_argument("Batch output must be at least as long as batch input.");
+
+    double b[groupBlock];
+    for (std::size_t s = 0; s < x.size(); s += groupBlock) {
+        const std::size_t m = std::min(groupBlock, x.size() - s);
+        const std::span<const double> xs = x.subspan(s, m);
+        const std::span<double> rs = r.subspan(s, m);
+        std::fill(rs.begin(), rs.end(), 0.);
+
+        for (std::size_t i = 0; i < g.normal.w.size(); ++i) {
+            for (std::size_t j = 0; j < m; ++j) {b[j] = normalArg<F>(g.normal, i, xs[j]);}
+            normalFinish<F>(std::span<double>(b, m));
+            const double w = g.normal.w[i];
+            for (std::size_t j = 0; j < m; ++j) {rs[j] += w * b[j];}
+        }
+
+        for (std::size_t i = 0; i < g.uniform.w.size(); ++i) {
+            const double w = g.uniform.w[i];
+            for (std::size_t j = 0; j < m; ++j) {rs[j] += w * uniformAt<F>(g.uniform, i, xs[j]);}
+        }
+
+        for (std::size_t i = 0; i < g.other.size(); ++i) {
+            (g.other[i]->*f)(xs, std::span<double>(b, m));
+            const double w = g.otherW[i];
+            for (std::size_t j = 0; j < m; ++j) {rs[j] += w * b[j];}
+        }
+    }
+}
+
+}   // namespace
+
+double dGroups::pdf(const double x) const {
+    return groupsAt<mixFn::pdf>(*this, x, &probDistr::pdf);
+}
+
+double dGroups::cdf(const double x) const {
+    return groupsAt<mixFn::cdf>(*this, x, &probDistr::cdf);
+}
+
+double dGroups::sf(const double x) const {
+    return groupsAt<mixFn::sf>(*this, x, &probDistr::sf);
+}
+
+void dGroups::pdf(std::span<const double> x, std::span<double> r) const {
+    groupsAt<mixFn::pdf>(*this, x, r, &probDistr::pdf);
+}
+
+void dGroups::cdf(std::span<const double> x, std::span<double> r) const {
+    groupsAt<mixFn::cdf>(*this, x, r, &probDistr::cdf);
+}
+
+void dGroups::sf(std::span<const double> x, std::span<double> r) const {
+    groupsAt<mixFn::sf>(*this, x, r, &probDistr::sf);
+}
+
+double dCtr::reduce(const std::size_t maxComponents, const double maxCost) {
+    constexpr std::uint32_t none = ~std::uint32_t(0);
+    struct gauss {
+        double w, raw, mu, var, logVar;
+        probDistr* src;         // nullptr for a merger
+        std::uint32_t ver;      // bumped when a merger takes the slot
+        bool alive;
+        std::uint32_t prev, next;   // neighbours in order of mean
+    };
+    std::vector<gauss> g;
+    for (const auto& [d,ws] : ingreds) {
+        if (d->getID() != dFuncID::NORMAL_DISTR) continue;
+        g.push_back({ws.second, ws.first, d->mean(), d->variance(), log(d->variance()), d, 0, true, none, none});
+    }
+    std::size_t count = ingreds.size();
+    if (count <= maxComponents || g.size() < 2) return 0;
+
+    // The slots, sorted by mean, form a list in order of mean. A merger
+    // takes the slot of one of the two it replaces; its mean lies between
+    // theirs, so it moves at most a few places to keep the list sorted.
+    std::sort(g.begin(), g.end(), [](const gauss& a, const gauss& b){ return a.mu < b.mu; });
+    const auto n = static_cast<std::uint32_t>(g.size());
+    for (std::uint32_t i = 0; i < n; ++i) {
+        g[i].prev = i ? i-1 : none;
+        g[i].next = i+1 < n ? i+1 : none;
+    }
+    auto unlink = [&g](const std::uint32_t k) {
+        if (g[k].prev != none) g[g[k].prev].next = g[k].next;
+        if (g[k].next != none) g[g[k].next].prev = g[k].prev;
+    };
+    auto linkAfter = [&g](const std::uint32_t k, const std::uint32_t at) {
+        g[k].prev = at;
+        g[k].next = g[at].next;
+        if (g[at].next != none) g[g[at].next].prev = k;
+        g[at].next = k;
+    };
+    auto linkBefore = [&g](const std::uint32_t k, const std::uint32_t at) {
+        g[k].next = at;
+        g[k].prev = g[at].prev;
+        if (g[at].prev != none) g[g[at].prev].next = k;
+        g[at].prev = k;
+    };
+
+    // The normal that merges i and j, in i's place in the list.
+    auto merged = [&g](const std::uint32_t i, const std::uint32_t j) {
+        const gauss& a = g[i];
+        const gauss& b = g[j];
+        const double w = a.w + b.w;
+        const double d = a.mu - b.mu;
+        const double var = (a.w*a.var + b.w*b.var)/w + a.w*b.w*d*d/(w*w);
+        return gauss{w, a.raw + b.raw, (a.w*a.mu + b.w*b.mu)/w, var, log(var), nullptr, a.ver + 1, true, a.prev, a.next};
+    };
+    // Runnalls' cost of that merge.
+    auto cost = [&g](const std::uint32_t i, const std::uint32_t j, const gauss& m) {
+        return 0.5*(m.w*m.logVar - g[i].w*g[i].logVar - g[j].w*g[j].logVar);
+    };
+
+    struct candidate {
+        double cost;
+        std::uint32_t i, j, iVer, jVer;
+        bool operator > (const candidate& o) const {return cost > o.cost;}
+    };
+    std::priority_queue<candidate, std::vector<candidate>, std::greater<candidate>> queue;
+    auto current = [&g](const std::uint32_t i, const std::uint32_t ver) {
+        return g[i].alive && g[i].ver == ver;
+    };
+
+    // Each normal queues only its cheapest partner among its neighbours,
+    // and looks again once that partner is gone.
+    auto pair = [&](const std::uint32_t i) {
+        candidate best{std::numeric_limits<double>::infinity(), i, i, g[i].ver, 0};
+        auto consider = [&](const std::uint32_t j) {
+            const double c = cost(i, j, merged(i, j));
+            if (c < best.cost) best = {c, i, j, g[i].ver, g[j].ver};
+        };
+        std::uint32_t k = i;
+        for (std::size_t s = 0; s < reduceWindow && (k = g[k].prev) != none; ++s) {consider(k);}
+        k = i;
+        for (std::size_t s = 0; s < reduceWindow && (k = g[k].next) != none; ++s) {consider(k);}
+        if (best.j != i) queue.push(best);
+    };
+    for (std::uint32_t i = 0; i < n; ++i) {pair(i);}
+
+    std::vector<probDistr*> gone;
+    double total = 0;
+    while (count > maxComponents && !queue.empty()) {
+        const candidate c = queue.top();
+        if (c.cost > maxCost) break;
+        queue.pop();
+        if (!current(c.i, c.iVer)) continue;
+        if (!current(c.j, c.jVer)) {pair(c.i); continue;}
+
+        for (const auto k : {c.i, c.j}) {
+            if (g[k].src) gone.push_back(g[k].src);
+        }
+        unlink(c.j);
+        g[c.j].alive = false;
+        g[c.i] = merged(c.i, c.j);
+        for (std::uint32_t p; (p = g[c.i].prev) != none && g[p].mu > g[c.i].mu; ) {unlink(c.i); linkBefore(c.i, p);}
+        for (std::uint32_t q; (q = g[c.i].next) != none && g[q].mu < g[c.i].mu; ) {unlink(c.i); linkAfter(c.i, q);}
+        pair(c.i);
+        total += c.cost;
+        --count;
+    }
+
+    // Swap the merged-away normals for the mergers.
+    for (probDistr* d : gone) {
+        ingreds.erase(d);
+        // The index owns the component; erasing it there destroys it.
+        const auto [b, e] = index.equal_range(d->hash());
+        for (auto it = b; it != e; ++it) {
+            if (it->second.get() == d) {index.erase(it); break;}
+        }
+    }
+    for (const auto& m : g) {
+        if (!m.src && m.alive) place(disNormal(m.mu, m.var), m.raw, false);
+    }
+    rescale();
+    return total;
+}
+
 std::ostream& operator << (std::ostream& output, const dCtr& distr) {
     distr.print(output);
     return output;
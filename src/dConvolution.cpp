@@ -15,9 +15,25 @@
 */
 #include <iostream>
 #include "dConvolution.h"
+#include "parallelSampler.h"
+#include "distrArena.h"
+#include <map>
+#include <memory>
+#include <mutex>
 
 namespace statanaly {
 
+namespace {
+
+/** A result: in the calling thread's distrArena, if one is in scope, else by new. */
+template<class T, class... Args>
+T* result(Args&&... args) {
+    if (distrArena* a = distrArena::current()) return a->make<T>(std::forward<Args>(args)...);
+    return new T(std::forward<Args>(args)...);
+}
+
+}   // namespace
+
 /**
  * @brief Global object for double dispacher that compute R = X + Y.
  */
@@ -68,17 +84,17 @@ auto ConvolutionSSqrtDoubleDispatcherInitialization = [](){
  */
 
 probDistr* convolve(disStdUniform& l, disStdUniform& r) {
-    probDistr* res = new disIrwinHall(2);
+    probDistr* res = result<disIrwinHall>(2);
     return res;
 };
 
 probDistr* convolve(disNormal& l, disNormal& r) {
-    probDistr* res = new disNormal(l.mean()+r.mean(), l.variance()+r.variance());
+    probDistr* res = result<disNormal>(l.mean()+r.mean(), l.variance()+r.variance());
     return res;
 };
 
 probDistr* convolve(disCauchy& l, disCauchy& r) {
-    probDistr* res = new disCauchy(l.ploc()+r.ploc(), l.pscale()+r.pscale());
+    probDistr* res = result<disCauchy>(l.ploc()+r.ploc(), l.pscale()+r.pscale());
     return res;
 };
 
@@ -87,7 +103,7 @@ probDistr* convolve(disGamma& l, disGamma& r) {
     if (l.pscale() != r.pscale())
         throw std::invalid_argument("convolve(Gamma,Gamma) requires Gamma distributions' scale parameters to be identical.");
 
-    probDistr* res = new disGamma(l.pscale(), l.pshape()+r.pshape());
+    probDistr* res = result<disGamma>(l.pscale(), l.pshape()+r.pshape());
     return res;
 };
 
@@ -96,7 +112,7 @@ probDistr* convolve(disExponential& l, disExponential& r) {
     if (l.prate() != r.prate())
         throw std::invalid_argument("convolve(Exponential,Exponential) requires Exponential distributions' rate parameters to be identical.");
 
-    probDistr* res = new disErlang(2, l.prate());
+    probDistr* res = result<disErlang>(2, l.prate());
     return res;
 };
 
@@ -109,10 +125,10 @@ probDistr* convolveSq(disNormal& l, disNormal& r) {
     // Else, return noncentral chi squared distribution.
     probDistr* res = nullptr;
     if (l.mean()==0 && r.mean()==0)
-        res = new disChiSq(2);
+        res = result<disChiSq>(2);
     else {
         auto a = l.mean()*l.mean() + r.mean()*r.mean();
-        res = new disNcChiSq(2,a);
+        res = result<disNcChiSq>(2,a);
     }
 
     return res;
@@ -127,10 +143,10 @@ probDistr* convolveSSqrt(disNormal& l, disNormal& r) {
     // Else, return Rician distribution.
     probDistr* res = nullptr;
     if (l.mean()==0 && r.mean()==0)
-        res = new disRayleigh(l.stddev());
+        res = result<disRayleigh>(l.stddev());
     else {
         auto a = std::sqrt(l.mean()*l.mean() + r.mean()*r.mean());
-        res = new disRician(a, l.stddev());
+        res = result<disRician>(a, l.stddev());
     }
 
     return res;
@@ -141,7 +157,7 @@ probDistr* convolveSSqrt(disNormal& l, disNormal& r) {
 
 template<>
 probDistr* convolve<disStdUniform> (std::initializer_list<disStdUniform> l) {
-    probDistr* res = new disIrwinHall(l.size());
+    probDistr* res = result<disIrwinHall>(l.size());
     return res;
 };
 
@@ -152,7 +168,7 @@ probDistr* convolve<disNormal> (std::initializer_list<disNormal> l) {
         m += e.mean();
         v += e.variance();
     }
-    probDistr* res = new disNormal(m, v);
+    probDistr* res = result<disNormal>(m, v);
 
     return res;
 };
@@ -164,7 +180,7 @@ probDistr* convolve<disCauchy> (std::initializer_list<disCauchy> l) {
         m += e.ploc();
         v += e.pscale();
     }
-    probDistr* res = new disCauchy(m, v);
+    probDistr* res = result<disCauchy>(m, v);
 
     return res;
 };
@@ -177,7 +193,7 @@ probDistr* convolve<disGamma> (std::initializer_list<disGamma> l) {
         if (n != e.pscale()) 
             throw std::invalid_argument("Convolve({Gamma_i}) requires Gamma distributions' scale parameters to be identical.");
     }
-    probDistr* res = new disGamma(n, m);
+    probDistr* res = result<disGamma>(n, m);
 
     return res;
 };
@@ -189,7 +205,7 @@ probDistr* convolve<disExponential> (std::initializer_list<disExponential> l) {
         if (n != e.prate()) 
             throw std::invalid_argument("Convolve({Exponential_i}) requires Exponential distributions' rate parameters to be identical.");
     }
-    probDistr* res = new disErlang(l.size(), n);
+    probDistr* res = result<disErlang>(l.size(), n);
 
     return res;
 };
@@ -211,9 +227,9 @@ probDistr* convolveSq<disNormal> (std::initializer_list<disNormal> l) {
     // Else, then it is Non-central Chi Square.
     probDistr* res = nullptr;
     if (mu==0)
-        res = new disChiSq(l.size());
+        res = result<disChiSq>(l.size());
     else 
-        res = new disNcChiSq(l.size(), a);
+        res = result<disNcChiSq>(l.size(), a);
 
     return res;    
 }
@@ -235,11 +251,69 @@ probDistr* convolveSSqrt<disNormal> (std::initializer_list<disNormal> l) {
     // Else, then it is Non-central Chi.
     probDistr* res = nullptr;
     if (mu==0)
-        res = new disChi(l.size());
+        res = result<disChi>(l.size());
     else 
-        res = new disNcChi(l.size(), sqrt(a));
+        res = result<disNcChi>(l.size(), sqrt(a));
 
     return res;
 };
 
-}   // namespace statanaly
\ No newline at end of file
+
+
+/* Monte Carlo convolution ------- */
+
+namespace {
+
+/** The pool for opt.threads, started on first use and kept until exit. */
+parallelSampler& sharedSampler(const unsigned threads) {
+    static std::mutex lock;
+    static std::map<unsigned, std::unique_ptr<parallelSampler>> pools;
+    std::lock_guard<std::mutex> guard(lock);
+    auto& p = pools[threads];
+    if (!p) p = std::make_unique<parallelSampler>(threads);
+    return *p;
+}
+
+/** opt.samples draws of combine(X, Y). */
+template<class Combine>
+disEmpirical* monteCarlo(const probDistr& lhs, const probDistr& rhs, const mcOptions& opt, Combine combine) {
+    if (opt.samples == 0)
+        throw std::invalid_argument("Monte Carlo convolution requires a non-zero sample budget.");
+
+    std::vector<double> x(opt.samples), y(opt.samples);
+    const sampleJob jobs[2] = {{&lhs, x}, {&rhs, y}};
+    parallelSampler& sampler = opt.sampler ? *opt.sampler : sharedSampler(opt.threads);
+    sampler.run(jobs, opt.seed);
+    for (std::size_t i=0; i<x.size(); ++i) {x[i] = combine(x[i], y[i]);}
+
+    return result<disEmpirical>(std::move(x));
+}
+
+}   // namespace
+
+
+disEmpirical* convolveMC(const probDistr& lhs, const probDistr& rhs, const mcOptions& opt) {
+    return monteCarlo(lhs, rhs, opt, [](const double a, const double b){ return a + b; });
+}
+
+disEmpirical* convolveSqMC(const probDistr& lhs, const probDistr& rhs, const mcOptions& opt) {
+    return monteCarlo(lhs, rhs, opt, [](const double a, const double b){ return a*a + b*b; });
+}
+
+disEmpirical* convolveSSqrtMC(const probDistr& lhs, const probDistr& rhs, const mcOptions& opt) {
+    return monteCarlo(lhs, rhs, opt, [](const double a, const double b){ return std::hypot(a, b); });
+}
+
+void enableMonteCarloFallback(const mcOptions& opt) {
+    cnvl.setFallback([opt](probDistr& l, probDistr& r) -> probDistr* { return convolveMC(l, r, opt); });
+    cnvlSq.setFallback([opt](probDistr& l, probDistr& r) -> probDistr* { return convolveSqMC(l, r, opt); });
+    cnvlSSqrt.setFallback([opt](probDistr& l, probDistr& r) -> probDistr* { return convolveSSqrtMC(l, r, opt); });
+}
+
+void disableMonteCarloFallback() {
+    cnvl.clearFallback();
+    cnvlSq.clearFallback();
+    cnvlSSqrt.clearFallback();
+}
+
+}   // namespace statanaly
@@ -0,0 +1,141 @@
+/*
+   Copyright 2022, Ansel Blumers
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "density/disEmpirical.h"
+#include <fcntl.h>      // open
+#include <sys/mman.h>   // mmap
+#include <unistd.h>     // close
+#include <fstream>
+
+namespace statanaly {
+
+namespace {
+
+/** A file mapped into memory, unmapped with its last owner. */
+struct mapping {
+    void* p = MAP_FAILED;
+    std::size_t len = 0;
+
+    mapping(const std::filesystem::path& file, const bool writable) {
+        const int fd = ::open(file.c_str(), writable ? O_RDWR : O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error("Cannot open " + file.string() + ".");
+        const std::uintmax_t size = std::filesystem::file_size(file);
+        if (size == 0 || size % sizeof(double)) {
+            ::close(fd);
+            throw std::invalid_argument(size ? "Empirical distribution file " + file.string() + " is not a whole number of doubles."
+                                             : std::string("Empirical distribution takes at least one sample.\n"));
+        }
+        len = size;
+        p = ::mmap(nullptr, len, writable ? PROT_READ|PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED)
+            throw std::runtime_error("Cannot map " + file.string() + ".");
+    }
+
+    ~mapping() {
+        if (p != MAP_FAILED) ::munmap(p, len);
+    }
+
+    mapping(const mapping&) = delete;
+    mapping& operator=(const mapping&) = delete;
+
+    double* data() const noexcept {
+        return static_cast<double*>(p);
+    }
+
+    std::size_t size() const noexcept {
+        return len / sizeof(double);
+    }
+};
+
+}   // namespace
+
+
+disEmpirical::disEmpirical(std::vector<double> samples) {
+    if (std::any_of(samples.begin(), samples.end(), [](const double v){ return std::isnan(v); }))
+        throw std::invalid_argument("Empirical distribution takes no NaN samples.\n");
+    std::sort(samples.begin(), samples.end());
+    auto v = std::make_shared<const std::vector<double>>(std::move(samples));
+    xs = *v;
+    store = std::move(v);
+    build();
+}
+
+disEmpirical::disEmpirical(const std::filesystem::path& file, const bool sortInPlace) {
+    auto m = std::make_shared<mapping>(file, false);
+    ::madvise(m->p, m->len, MADV_SEQUENTIAL);
+    const double* d = m->data();
+    bool sorted = true;
+    for (std::size_t i = 0; i < m->size(); ++i) {
+        if (std::isnan(d[i]))
+            throw std::invalid_argument("Empirical distribution takes no NaN samples.\n");
+        if (i && d[i] < d[i-1]) sorted = false;
+    }
+
+    if (!sorted) {
+        if (!sortInPlace)
+            throw std::invalid_argument("Empirical distribution file " + file.string() + " is not sorted.");
+        m = std::make_shared<mapping>(file, true);
+        std::sort(m->data(), m->data() + m->size());
+        ::msync(m->p, m->len, MS_SYNC);
+    }
+    xs = std::span<const double>(m->data(), m->size());
+    build();
+
+    // From here on, cdf and quantile touch pages at random.
+    ::madvise(m->p, m->len, MADV_RANDOM);
+    store = std::move(m);
+}
+
+void disEmpirical::build() {
+    if (xs.empty())
+        throw std::invalid_argument("Empirical distribution takes at least one sample.\n");
+
+    // Two passes; the central sums are accumulated in long double.
+    const std::size_t n = xs.size();
+    long double s = 0;
+    sampleHash = 0;
+    combine_hash(sampleHash, char(id));
+    for (const double v : xs) {
+        s += v;
+        combine_hash(sampleHash, v);
+    }
+    mu = s / n;
+    long double m2 = 0, m3 = 0;
+    for (const double v : xs) {
+        const long double d = v - mu;
+        m2 += d*d;
+        m3 += d*d*d;
+    }
+    var = m2 / n;
+    skew = m2 > 0 ? double(m3/n / std::pow(m2/n, 1.5L)) : 0;
+
+    // Silverman: 0.9 min(sd, IQR/1.34) n^-1/5 for a normal kernel; a window
+    // of the same variance is sqrt(3) times as wide on each side.
+    const double iqr = quantile(0.75) - quantile(0.25);
+    double spread = std::sqrt(var);
+    if (iqr > 0) spread = std::min(spread, iqr/1.34);
+    halfWidth = std::sqrt(3.) * 0.9 * spread * std::pow(double(n), -0.2);
+}
+
+void disEmpirical::save(const std::filesystem::path& file) const {
+    std::ofstream out(file, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(xs.data()), xs.size_bytes());
+    if (!out)
+        throw std::runtime_error("Cannot write " + file.string() + ".");
+}
+
+}   // namespace statanaly
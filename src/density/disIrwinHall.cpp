@@ -0,0 +1,230 @@
+/*
+   Copyright 2022, Ansel Blumers
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "density/disIrwinHall.h"
+
+namespace statanaly {
+
+namespace {
+
+/** U(0,1) tilted by exp(-a u), a >= 0: log E[exp(-aU)], its mean and cumulants k[2..6]. */
+struct tiltedUniform {
+    double logMgf, mean, k[7];
+
+    explicit tiltedUniform(const double a) {
+        // L[r] = int_0^1 u^r exp(-a u) du. The upward recurrence loses r/a per
+        // step, so small a takes the series instead.
+        double L[7];
+        if (a < 2) {
+            for (int r = 0; r < 7; ++r) {
+                double term = 1, sum = 1./(r+1);
+                for (int j = 1; j < 40; ++j) {
+                    term *= -a/j;
+                    sum += term/(r+j+1);
+                }
+                L[r] = sum;
+            }
+        } else {
+            const double e = std::exp(-a);
+            L[0] = -std::expm1(-a)/a;
+            for (int r = 1; r < 7; ++r) {L[r] = (r*L[r-1] - e)/a;}
+        }
+        logMgf = std::log(L[0]);
+        mean = L[1]/L[0];
+
+        // Central moments c[r], then cumulants.
+        double c[7] = {1, 0};
+        for (int r = 2; r < 7; ++r) {
+            double binom = 1, pw = 1, sum = 0;
+            for (int i = r; i >= 0; --i) {
+                sum += binom * L[i]/L[0] * pw;
+                binom = binom * i / (r-i+1);
+                pw *= -mean;
+            }
+            c[r] = sum;
+        }
+        k[2] = c[2];
+        k[3] = c[3];
+        k[4] = c[4] - 3*c[2]*c[2];
+        k[5] = c[5] - 10*c[3]*c[2];
+        k[6] = c[6] - 15*c[4]*c[2] - 10*c[3]*c[3] + 30*c[2]*c[2]*c[2];
+    }
+};
+
+/**
+ * Log density of the sum of N uniforms at 0 < y <= N/2 by the saddle-point
+ * approximation, with Daniels' corrections through O(N^-2). a is the tilt to
+ * start from (none when <= 0) and returns the saddle point.
+ */
+double saddlepointLogDensity(const double y, const unsigned N, double& a) {
+    // Saddle point: mean of the tilted uniform equals y/N. The mean falls
+    // from 1/2 at a = 0 and stays below 1/a, which brackets the root.
+    const double ybar = y / N;
+    double lo = 0, hi = 1/ybar;
+    if (!(a > lo && a < hi)) a = ybar > 0.25 ? 12*(0.5-ybar) : 1/ybar - 2;
+    tiltedUniform t(a);
+    for (int it = 0; it < 100; ++it) {
+        const double f = t.mean - ybar;
+        if (f > 0) lo = a; else hi = a;
+        double next = a + f/t.k[2];
+        if (!(next > lo && next < hi)) next = 0.5*(lo+hi);
+        const bool done = std::abs(next-a) <= 1e-12*a;
+        a = next;
+        t = tiltedUniform(a);
+        if (done) break;
+    }
+
+    const double K2 = N*t.k[2];
+    const double l3 = N*t.k[3] / std::pow(K2, 1.5);
+    const double l4 = N*t.k[4] / (K2*K2);
+    const double l5 = N*t.k[5] / std::pow(K2, 2.5);
+    const double l6 = N*t.k[6] / (K2*K2*K2);
+    const double corr = (l4/8 - 5*l3*l3/24)
+        + (-l6/48 + 35*l4*l4/384 + 7*l3*l5/48 - 35*l3*l3*l4/64 + 385*l3*l3*l3*l3/1152);
+    return N*t.logMgf + a*y - 0.5*std::log(2*M_PI*K2) + std::log1p(corr);
+}
+
+}
+
+void disIrwinHall::buildEdgeworth() {
+    edgeCoef.clear();
+    edgeLast.clear();
+    if (n < edgeworthMinN) return;
+
+    // Cumulants of the standardized sum: kappa_{2r}(U(0,1)) * 12^r / n^(r-1),
+    // with kappa_{2r} = B_{2r}/(2r). Divided by (2r)! they are kappa[r]/n^(r-1).
+    constexpr double kappa[] = {0, 0, -1./20, 1./105, -3./1400, 1./1925,
+        -691./5255250, 6./175175, -10851./1191190000, 43867./17823180375};
+    constexpr int K = edgeworthOrder;
+    constexpr int D = 4*K + 1;
+
+    // exp(sum_k A_k) graded by powers of 1/n, A_k = kappa[k+1] u^(2k+2) / n^k:
+    // E_0 = 1, k E_k = sum_j j A_j E_{k-j}. The coefficient of u^j becomes
+    // that of He_j(z) in the density.
+    double E[K+1][D] = {};
+    E[0][0] = 1;
+    for (int k = 1; k <= K; ++k) {
+        for (int j = 1; j <= k; ++j) {
+            const double a = j * kappa[j+1] / std::pow(double(n), j) / k;
+            const int d = 2*j + 2;
+            for (int i = 0; i + d < D; ++i) {E[k][i+d] += a * E[k-j][i];}
+        }
+    }
+
+    edgeCoef.assign(D, 0);
+    edgeLast.assign(E[K], E[K] + D);
+    for (int k = 0; k <= K; ++k) {
+        for (int i = 0; i < D; ++i) {edgeCoef[i] += E[k][i];}
+    }
+}
+
+double disIrwinHall::spline(const double y, const bool cumulative) const {
+    // Values at y-j, j = 0..J, of the density (cdf) of the sum of m uniforms:
+    //   f_m(y) = (y f_{m-1}(y) + (m-y) f_{m-1}(y-1)) / (m-1),
+    //   F_m(y) = (y F_{m-1}(y) + (m-y) F_{m-1}(y-1)) / m.
+    // Only j <= n-m is still needed for the final f_n(y), and j < J-m+1 lies
+    // past the support of f_m (where F_m is 1).
+    const std::size_t J = static_cast<std::size_t>(y);
+    const double t = y - J;
+    thread_local std::vector<double> v;
+    v.assign(J+2, cumulative ? 1. : 0.);
+    v[J] = cumulative ? t : 1.;
+    v[J+1] = 0;
+
+    for (unsigned m = 2; m <= n; ++m) {
+        const std::size_t lo = J+1 > m ? J+1-m : 0;
+        const std::size_t hi = std::min<std::size_t>(J, n-m);
+        const double inv = 1. / (cumulative ? m : m-1);
+        for (std::size_t j = lo; j <= hi; ++j) {
+            const double yj = y - j;
+            v[j] = (yj*v[j] + (m-yj)*v[j+1]) * inv;
+        }
+    }
+    return v[0];
+}
+
+double disIrwinHall::saddlepoint(const double y, const bool cumulative) const {
+    if (!(y > 0)) return 0;
+    double a = 0;
+    if (!cumulative) return std::exp(saddlepointLogDensity(y, n, a));
+
+    // F_n(y) = sum_{k>=0} f_{n+1}(y-k), from f_{n+1}(y) = F_n(y) - F_n(y-1).
+    // Terms fall roughly by exp(-a) each, so the sum is short in the tails.
+    const double l0 = saddlepointLogDensity(y, n+1, a);
+    double sum = 1;
+    for (double x = y-1; x > 0; x -= 1) {
+        const double term = std::exp(saddlepointLogDensity(x, n+1, a) - l0);
+        sum += term;
+        if (term <= 1e-17*sum) break;
+    }
+    return std::exp(l0) * sum;
+}
+
+double disIrwinHall::edgeworth(const double z, const double g, const double c, const bool cumulative) const {
+    // Hermite recurrence He_{j+1} = z He_j - j He_{j-1}; the density pairs
+    // edgeCoef[j] with He_j, the cdf pairs it with He_{j-1}.
+    double hPrev = 1, h = z;
+    double sum = cumulative ? 0 : edgeCoef[0];
+    double last = cumulative ? 0 : edgeLast[0];
+    for (std::size_t j = 1; j < edgeCoef.size(); ++j) {
+        const double he = cumulative ? hPrev : h;
+        sum += edgeCoef[j]*he;
+        last += edgeLast[j]*he;
+        const double hNext = z*h - j*hPrev;
+        hPrev = h;
+        h = hNext;
+    }
+
+    // g = exp(-z^2/2), c = erfc(-z/sqrt(2)).
+    const double phi = g * (0.5*M_2_SQRTPI*M_SQRT1_2);
+    const double res = cumulative ? 0.5*c - phi*sum : phi*sum / sigma;
+    const double err = cumulative ? phi*last : phi*last / sigma;
+    if (!(std::abs(err) <= edgeworthTol*std::abs(res))) return NAN;
+    return res;
+}
+
+void disIrwinHall::lower(std::span<double> y, const bool cumulative) const {
+    if (edgeCoef.empty()) {
+        for (auto& v : y) {v = lower(v, cumulative);}
+        return;
+    }
+
+    constexpr std::size_t B = 256;
+    double z[B], g[B], c[B];
+    for (std::size_t s = 0; s < y.size(); s += B) {
+        const std::size_t m = std::min(B, y.size() - s);
+        std::span<double> ys = y.subspan(s, m);
+
+        for (std::size_t i = 0; i < m; ++i) {
+            z[i] = (ys[i] - 0.5*n) / sigma;
+            g[i] = -0.5*z[i]*z[i];
+            c[i] = -z[i]*M_SQRT1_2;
+        }
+        vecExp(std::span<const double>(g, m), std::span<double>(g, m));
+        if (cumulative) vecErfc(std::span<const double>(c, m), std::span<double>(c, m));
+
+        for (std::size_t i = 0; i < m; ++i) {
+            const double v = ys[i];
+            if (!(v >= 0)) {
+                ys[i] = std::isnan(v) ? v : 0;
+                continue;
+            }
+            const double e = edgeworth(z[i], g[i], c[i], cumulative);
+            ys[i] = std::isnan(e) ? tail(v, cumulative) : e;
+        }
+    }
+}
+
+}
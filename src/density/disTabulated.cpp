@@ -0,0 +1,110 @@
+/*
+   Copyright 2022, Ansel Blumers
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "density/disTabulated.h"
+
+namespace statanaly {
+
+void disTabulated::build() {
+    constexpr std::size_t M = NCOEF;
+
+    // Chebyshev nodes on [-1, 1], the DCT that maps values at the nodes to
+    // coefficients, and the points halfway between the nodes (in angle)
+    // plus both ends, where the interpolation error peaks.
+    double node[M], check[M+1], dct[M][M];
+    for (std::size_t j = 0; j < M; ++j) {
+        node[j] = std::cos(M_PI*(j+0.5)/M);
+        for (std::size_t k = 0; k < M; ++k) {
+            dct[k][j] = (k ? 2. : 1.)/M * std::cos(M_PI*k*(j+0.5)/M);
+        }
+    }
+    for (std::size_t j = 0; j <= M; ++j) {check[j] = std::cos(M_PI*j/M);}
+
+    struct Span {double a, b; int depth;};
+    std::vector<Span> todo{{lo, hi, 0}};
+    edges.assign(1, lo);
+    pdfCoef.clear();
+    cdfCoef.clear();
+    errPdf = 0;
+    errCdf = 0;
+
+    // Depth first, left half first, so panels are produced in order.
+    double cp[M], cc[M];
+    while (!todo.empty()) {
+        const Span sp = todo.back();
+        todo.pop_back();
+        const double c = 0.5*(sp.a+sp.b), h = 0.5*(sp.b-sp.a);
+
+        double fp[M], fc[M];
+        for (std::size_t j = 0; j < M; ++j) {
+            fp[j] = exact->pdf(c + h*node[j]);
+            fc[j] = exact->cdf(c + h*node[j]);
+        }
+        for (std::size_t k = 0; k < M; ++k) {
+            cp[k] = 0;
+            cc[k] = 0;
+            for (std::size_t j = 0; j < M; ++j) {
+                cp[k] += dct[k][j]*fp[j];
+                cc[k] += dct[k][j]*fc[j];
+            }
+        }
+
+        // A NaN error (eg. a singular pdf) is kept, so it is never mistaken for convergence.
+        double ep = 0, ec = 0;
+        for (std::size_t j = 0; j <= M; ++j) {
+            const double t2 = 2*check[j];
+            double p1 = 0, p2 = 0, c1 = 0, c2 = 0;
+            for (std::size_t k = M-1; k > 0; --k) {
+                const double p0 = t2*p1 - p2 + cp[k];
+                const double c0 = t2*c1 - c2 + cc[k];
+                p2 = p1; p1 = p0;
+                c2 = c1; c1 = c0;
+            }
+            const double x = c + h*check[j];
+            const double dp = std::abs(0.5*t2*p1 - p2 + cp[0] - exact->pdf(x));
+            const double dc = std::abs(0.5*t2*c1 - c2 + cc[0] - exact->cdf(x));
+            if (!(dp <= ep)) ep = dp;
+            if (!(dc <= ec)) ec = dc;
+        }
+
+        const bool converged = ep <= tol && ec <= tol;
+        const bool full = edges.size() + todo.size() + 1 > maxPanels;
+        if (!converged && !full && sp.depth < maxDepth) {
+            todo.push_back({c, sp.b, sp.depth+1});
+            todo.push_back({sp.a, c, sp.depth+1});
+            continue;
+        }
+
+        edges.push_back(todo.empty() ? hi : sp.b);
+        pdfCoef.insert(pdfCoef.end(), cp, cp+M);
+        cdfCoef.insert(cdfCoef.end(), cc, cc+M);
+        if (!(ep <= errPdf)) errPdf = ep;
+        if (!(ec <= errCdf)) errCdf = ec;
+    }
+    nPanel = edges.size()-1;
+
+    // Cell g of the lookup grid covers [lo + g*w, lo + (g+1)*w), w = (hi-lo)/nCell.
+    const std::size_t nCell = 2*nPanel;
+    invCell = nCell/(hi-lo);
+    cell.assign(nCell+1, nPanel-1);
+    std::size_t i = 0;
+    for (std::size_t g = 0; g < nCell; ++g) {
+        const double x = lo + g/invCell;
+        while (i+1 < nPanel && edges[i+1] <= x) ++i;
+        cell[g] = i;
+    }
+}
+
+}   // namespace statanaly
@@ -24,4 +24,90 @@ std::ostream& operator << (std::ostream& output, const probDistr& distr) {
     return output;
 }
 
-}
\ No newline at end of file
+
+/* Generic log and survival functions.
+ * Derived classes override these with native forms.
+ */
+
+double probDistr::logpdf(const double x) const {
+    return std::log(pdf(x));
+}
+
+double probDistr::logcdf(const double x) const {
+    return std::log(cdf(x));
+}
+
+double probDistr::sf(const double x) const {
+    return 1. - cdf(x);
+}
+
+double probDistr::logsf(const double x) const {
+    return std::log1p(-cdf(x));
+}
+
+double probDistr::quantile(const double p) const {
+    checkProbability(p);
+
+    // Grow a bracket [lo, hi] geometrically until it encloses p.
+    double lo = -1, hi = 1;
+    while (cdf(lo) > p && !std::isinf(lo)) {
+        hi = lo;
+        lo *= 2;
+    }
+    while (cdf(hi) < p && !std::isinf(hi)) {
+        lo = hi;
+        hi *= 2;
+    }
+    if (std::isinf(lo)) return lo;
+    if (std::isinf(hi)) return hi;
+    return solveQuantile(p, lo, hi, 0.5*(lo+hi),
+        [this](const double x){ return cdf(x); },
+        [this](const double x){ return pdf(x); });
+}
+
+
+/* Generic sampling by inverse transform.
+ */
+
+double probDistr::draw(rngRef rng) const {
+    return quantile(toOpenUnit(rng()));
+}
+
+void probDistr::draw(rngRef rng, std::span<double> r) const {
+    for (auto& v : r) {v = draw(rng);}
+}
+
+
+/* Generic batch evaluation.
+ * Each element costs a virtual call. Derived classes override these.
+ */
+
+void probDistr::pdf(std::span<const double> x, std::span<double> r) const {
+    batchEval(x, r, [this](const double v){ return pdf(v); });
+}
+
+void probDistr::cdf(std::span<const double> x, std::span<double> r) const {
+    batchEval(x, r, [this](const double v){ return cdf(v); });
+}
+
+void probDistr::logpdf(std::span<const double> x, std::span<double> r) const {
+    batchEval(x, r, [this](const double v){ return logpdf(v); });
+}
+
+void probDistr::logcdf(std::span<const double> x, std::span<double> r) const {
+    batchEval(x, r, [this](const double v){ return logcdf(v); });
+}
+
+void probDistr::sf(std::span<const double> x, std::span<double> r) const {
+    batchEval(x, r, [this](const double v){ return sf(v); });
+}
+
+void probDistr::logsf(std::span<const double> x, std::span<double> r) const {
+    batchEval(x, r, [this](const double v){ return logsf(v); });
+}
+
+void probDistr::quantile(std::span<const double> p, std::span<double> r) const {
+    batchEval(p, r, [this](const double v){ return quantile(v); });
+}
+
+}
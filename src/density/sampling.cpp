@@ -0,0 +1,309 @@
+/*
+   Copyright 2022, Ansel Blumers
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "density/sampling.h"
+#include "density/vecMath.h"
+#include <cmath>
+
+namespace statanaly {
+
+
+namespace {
+
+/* Ziggurat ------------------------------------------- */
+
+/**
+ * Layers of the ziggurat of a decreasing density f on [0, inf), after
+ * Marsaglia & Tsang, "The ziggurat method for generating random variables"
+ * (2000). Layer i >= 1 is the strip of width x[i] between heights f[i]
+ * and f[i+1]; layer 0 is the base strip of width x[0], the rectangle
+ * [0, r] x [0, f(r)] plus the tail beyond r. All layers have area v.
+ */
+struct ziggurat {
+    double x[zigguratLayers+1];
+    double f[zigguratLayers+1];
+    double r;
+};
+
+template<class F, class FInv>
+ziggurat buildZiggurat(const long double r, const long double v, F f, FInv finv) {
+    ziggurat z;
+    z.r = double(r);
+    long double xi = r;
+    z.x[0] = double(v / f(r));
+    z.x[1] = double(r);
+    for (int i = 1; i < zigguratLayers-1; ++i) {
+        xi = finv(v/xi + f(xi));
+        z.x[i+1] = double(xi);
+    }
+    z.x[zigguratLayers] = 0;
+    for (int i = 0; i <= zigguratLayers; ++i) {z.f[i] = double(f((long double)z.x[i]));}
+    return z;
+}
+
+// r of the 256-layer tables from Marsaglia & Tsang; v is the area of the base strip.
+const ziggurat zigNormal = [] {
+    const long double r = 3.6541528853610088L;
+    auto f = [](const long double x){ return std::exp(-0.5L*x*x); };
+    const long double v = r*f(r) + std::sqrt(0.5L*M_PIl)*std::erfc(r*M_SQRT1_2l);
+    return buildZiggurat(r, v, f, [](const long double y){ return std::sqrt(-2*std::log(y)); });
+}();
+
+const ziggurat zigExponential = [] {
+    const long double r = 7.69711747013104972L;
+    auto f = [](const long double x){ return std::exp(-x); };
+    const long double v = r*f(r) + f(r);
+    return buildZiggurat(r, v, f, [](const long double y){ return -std::log(y); });
+}();
+
+/** Bits of a word: layer in the lowest 8, the sign in bit 8, toUnit() in the top 53. */
+inline int zigLayer(const std::uint64_t w) noexcept {return int(w & (zigguratLayers-1));}
+inline bool zigNegative(const std::uint64_t w) noexcept {return (w >> 8) & 1;}
+
+/**
+ * Finish a candidate x of layer i that fell outside the layer's core:
+ * the tail for i == 0, otherwise the wedge test. NaN when it is rejected.
+ */
+double normalOuter(rngRef rng, const int i, const double x) {
+    const auto& z = zigNormal;
+    if (i == 0) {
+        double a, b;
+        do {
+            a = -std::log(toOpenUnit(rng())) / z.r;
+            b = -std::log(toOpenUnit(rng()));
+        } while (b+b < a*a);
+        return z.r + a;
+    }
+    const double y = z.f[i] + toUnit(rng())*(z.f[i+1] - z.f[i]);
+    return y < std::exp(-0.5*x*x) ? x : NAN;
+}
+
+double exponentialOuter(rngRef rng, const int i, const double x) {
+    const auto& z = zigExponential;
+    if (i == 0) return z.r - std::log(toOpenUnit(rng()));
+    const double y = z.f[i] + toUnit(rng())*(z.f[i+1] - z.f[i]);
+    return y < std::exp(-x) ? x : NAN;
+}
+
+/** Magnitude of a ziggurat draw that starts with word w; rejected candidates draw afresh. */
+inline double zigDraw(rngRef rng, const ziggurat& z, double (*outer)(rngRef, int, double), std::uint64_t w) {
+    while (true) {
+        const int i = zigLayer(w);
+        const double x = toUnit(w) * z.x[i];
+        if (x < z.x[i+1]) return x;
+        const double t = outer(rng, i, x);
+        if (!std::isnan(t)) return t;
+        w = rng();
+    }
+}
+
+/**
+ * Batch of ziggurat draws. The first pass maps every word to its core
+ * candidate without branching; the ~1% that land outside the core are
+ * finished afterwards, drawing words of their own.
+ */
+template<bool Signed>
+void zigBlock(rngRef rng, std::span<double> r, const ziggurat& z, double (*outer)(rngRef, int, double)) {
+    constexpr std::size_t B = 256;
+    std::uint64_t w[B];
+    for (std::size_t s = 0; s < r.size(); s += B) {
+        const std::size_t m = std::min(B, r.size() - s);
+        rng.fill(std::span<std::uint64_t>(w, m));
+        double* v = r.data() + s;
+
+        std::size_t miss = 0;
+        for (std::size_t j = 0; j < m; ++j) {
+            const int i = zigLayer(w[j]);
+            v[j] = toUnit(w[j]) * z.x[i];
+            miss += !(v[j] < z.x[i+1]);
+        }
+        for (std::size_t j = 0; miss > 0 && j < m; ++j) {
+            if (!(v[j] < z.x[zigLayer(w[j])+1])) {
+                v[j] = zigDraw(rng, z, outer, w[j]);
+                --miss;
+            }
+        }
+        if constexpr (Signed) {
+            for (std::size_t j = 0; j < m; ++j) {v[j] = zigNegative(w[j]) ? -v[j] : v[j];}
+        }
+    }
+}
+
+}   // namespace
+
+
+double stdNormal(rngRef rng) {
+    const std::uint64_t w = rng();
+    const double x = zigDraw(rng, zigNormal, normalOuter, w);
+    return zigNegative(w) ? -x : x;
+}
+
+
+void stdNormal(rngRef rng, std::span<double> r) {
+    zigBlock<true>(rng, r, zigNormal, normalOuter);
+}
+
+
+double stdExponential(rngRef rng) {
+    return zigDraw(rng, zigExponential, exponentialOuter, rng());
+}
+
+
+void stdExponential(rngRef rng, std::span<double> r) {
+    zigBlock<false>(rng, r, zigExponential, exponentialOuter);
+}
+
+
+
+namespace {
+
+/**
+ * Marsaglia-Tsang candidate from a normal x and a uniform u, for shape
+ * a >= 1 with d = a-1/3, c = 1/sqrt(9d). NaN when rejected; the squeeze
+ * accepts ~98% without a log.
+ */
+inline double gammaCandidate(const double d, const double c, const double x, const double u) {
+    double v = 1 + c*x;
+    if (!(v > 0)) return NAN;
+    v = v*v*v;
+    const double x2 = x*x;
+    if (u < 1 - 0.0331*x2*x2) return d*v;
+    if (std::log(u) < 0.5*x2 + d*(1 - v + std::log(v))) return d*v;
+    return NAN;
+}
+
+/** Gamma(a, 1) for a >= 1. */
+double gammaAtLeastOne(rngRef rng, const double a) {
+    const double d = a - 1./3, c = 1/std::sqrt(9*d);
+    while (true) {
+        const double x = stdNormal(rng);
+        const double g = gammaCandidate(d, c, x, toOpenUnit(rng()));
+        if (!std::isnan(g)) return g;
+    }
+}
+
+}   // namespace
+
+
+double stdGamma(rngRef rng, double alpha) {
+    if (alpha >= 1) return gammaAtLeastOne(rng, alpha);
+    if (!(alpha > 0)) return alpha == 0 ? 0 : NAN;
+    // Boost: Gamma(alpha) = Gamma(alpha+1) * U^(1/alpha), in log form.
+    const double g = gammaAtLeastOne(rng, alpha + 1);
+    return g * std::exp(std::log(toOpenUnit(rng())) / alpha);
+}
+
+
+void stdGamma(rngRef rng, double alpha, std::span<double> r) {
+    if (!(alpha > 0)) {
+        std::fill(r.begin(), r.end(), alpha == 0 ? 0 : NAN);
+        return;
+    }
+    const double a = alpha < 1 ? alpha + 1 : alpha;
+    const double d = a - 1./3, c = 1/std::sqrt(9*d);
+
+    // One normal and one uniform per candidate, a block at a time; the
+    // few rejected candidates are redrawn one by one.
+    constexpr std::size_t B = 256;
+    double z[B];
+    std::uint64_t w[B];
+    for (std::size_t s = 0; s < r.size(); s += B) {
+        const std::size_t m = std::min(B, r.size() - s);
+        stdNormal(rng, std::span<double>(z, m));
+        rng.fill(std::span<std::uint64_t>(w, m));
+        double* v = r.data() + s;
+        for (std::size_t j = 0; j < m; ++j) {
+            const double g = gammaCandidate(d, c, z[j], toOpenUnit(w[j]));
+            v[j] = std::isnan(g) ? gammaAtLeastOne(rng, a) : g;
+        }
+        if (alpha < 1) {
+            double lu[B];
+            rng.fill(std::span<std::uint64_t>(w, m));
+            for (std::size_t j = 0; j < m; ++j) {lu[j] = toOpenUnit(w[j]);}
+            vecLog(std::span<const double>(lu, m), std::span<double>(lu, m));
+            for (std::size_t j = 0; j < m; ++j) {lu[j] /= alpha;}
+            vecExp(std::span<const double>(lu, m), std::span<double>(lu, m));
+            for (std::size_t j = 0; j < m; ++j) {v[j] *= lu[j];}
+        }
+    }
+}
+
+
+double stdErlang(rngRef rng, unsigned k) {
+    if (k > erlangProductMaxK) return gammaAtLeastOne(rng, k);
+    if (k == 0) return 0;
+    double p = toOpenUnit(rng());
+    for (unsigned i = 1; i < k; ++i) {p *= toOpenUnit(rng());}
+    return -std::log(p);
+}
+
+
+void stdErlang(rngRef rng, unsigned k, std::span<double> r) {
+    if (k > erlangProductMaxK) {
+        stdGamma(rng, k, r);
+        return;
+    }
+    if (k == 0) {
+        std::fill(r.begin(), r.end(), 0.);
+        return;
+    }
+
+    // k words per variate, 256/k variates per block, one vecLog per block.
+    constexpr std::size_t B = 256;
+    std::uint64_t w[B];
+    const std::size_t per = B / k;
+    for (std::size_t s = 0; s < r.size(); s += per) {
+        const std::size_t m = std::min(per, r.size() - s);
+        rng.fill(std::span<std::uint64_t>(w, m*k));
+        const std::span<double> v = r.subspan(s, m);
+        for (std::size_t i = 0; i < m; ++i) {
+            double p = toOpenUnit(w[i*k]);
+            for (std::size_t j = 1; j < k; ++j) {p *= toOpenUnit(w[i*k+j]);}
+            v[i] = p;
+        }
+        vecLog(v, v);
+        for (auto& x : v) {x = -x;}
+    }
+}
+
+
+double stdChiSq(rngRef rng, unsigned k) {
+    if (k == 1) {
+        const double z = stdNormal(rng);
+        return z*z;
+    }
+    if (k % 2 == 0) return 2*stdErlang(rng, k/2);
+    return 2*stdGamma(rng, 0.5*k);
+}
+
+
+void stdChiSq(rngRef rng, unsigned k, std::span<double> r) {
+    if (k == 1) {
+        stdNormal(rng, r);
+        for (auto& v : r) {v *= v;}
+        return;
+    }
+    if (k % 2 == 0) stdErlang(rng, k/2, r);
+    else stdGamma(rng, 0.5*k, r);
+    for (auto& v : r) {v *= 2;}
+}
+
+
+double stdPoisson(rngRef rng, double lambda) {
+    if (!(lambda > 0)) return 0;
+    return static_cast<double>(std::poisson_distribution<std::uint64_t>(lambda)(rng));
+}
+
+}
@@ -0,0 +1,192 @@
+/*
+   Copyright 2022, Ansel Blumers
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "density/vecMath.h"
+#include "vecMath_dispatch.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <stdexcept>
+
+namespace statanaly {
+
+namespace {
+
+/* Scalar fallback ------------------------------------ */
+
+template<double (*F)(double)>
+void scalarLoop(const double* x, double* r, std::size_t n) {
+    for (std::size_t i=0; i<n; ++i) {r[i] = F(x[i]);}
+}
+
+double libmExp (double x) {return std::exp(x);}
+double libmLog (double x) {return std::log(x);}
+double libmErf (double x) {return std::erf(x);}
+double libmErfc(double x) {return std::erfc(x);}
+double libmAtan(double x) {return std::atan(x);}
+
+void philoxScalar(const std::uint64_t key, const std::uint64_t stream, const std::uint64_t first,
+    std::uint64_t* r, const std::size_t nBlocks) {
+    for (std::size_t i=0; i<nBlocks; ++i) {
+        const std::uint64_t b = first + i;
+        std::uint32_t c0 = std::uint32_t(b), c1 = std::uint32_t(b >> 32);
+        std::uint32_t c2 = std::uint32_t(stream), c3 = std::uint32_t(stream >> 32);
+        std::uint32_t k0 = std::uint32_t(key), k1 = std::uint32_t(key >> 32);
+        for (int round=0; round<10; ++round, k0+=0x9E3779B9, k1+=0xBB67AE85) {
+            const std::uint64_t p0 = std::uint64_t(0xD2511F53) * c0;
+            const std::uint64_t p1 = std::uint64_t(0xCD9E8D57) * c2;
+            c0 = std::uint32_t(p1 >> 32) ^ c1 ^ k0;
+            c1 = std::uint32_t(p1);
+            c2 = std::uint32_t(p0 >> 32) ^ c3 ^ k1;
+            c3 = std::uint32_t(p0);
+        }
+        r[2*i]   = (std::uint64_t(c1) << 32) | c0;
+        r[2*i+1] = (std::uint64_t(c3) << 32) | c2;
+    }
+}
+
+const vecMathKernels scalarTable = {
+    scalarLoop<libmExp>,
+    scalarLoop<libmLog>,
+    scalarLoop<libmErf>,
+    scalarLoop<libmErfc>,
+    scalarLoop<libmAtan>,
+    [](const double* x, const double* y, double* r, std::size_t n) {
+        for (std::size_t i=0; i<n; ++i) {r[i] = std::pow(x[i], y[i]);}},
+    [](const double* x, const double y, double* r, std::size_t n) {
+        for (std::size_t i=0; i<n; ++i) {r[i] = std::pow(x[i], y);}},
+    philoxScalar,
+};
+
+
+/* Dispatch ------------------------------------------- */
+
+const vecMathKernels* tableOf(const simdISA isa) {
+    switch (isa) {
+        case simdISA::AVX512: return vecMathAVX512();
+        case simdISA::AVX2:   return vecMathAVX2();
+        case simdISA::SSE2:   return vecMathSSE2();
+        default:              return &scalarTable;
+    }
+}
+
+simdISA detect() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (vecMathAVX512() && __builtin_cpu_supports("avx512f"))
+        return simdISA::AVX512;
+    if (vecMathAVX2() && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return simdISA::AVX2;
+    if (vecMathSSE2() && __builtin_cpu_supports("sse2"))
+        return simdISA::SSE2;
+#endif
+    return simdISA::SCALAR;
+}
+
+const simdISA supported = detect();
+
+std::atomic<simdISA> active{supported};
+
+const vecMathKernels& kernels() {
+    return *tableOf(active.load(std::memory_order_relaxed));
+}
+
+void checkSize(const std::size_t nx, const std::size_t nr) {
+    if (nr < nx)
+        throw std::invalid_argument("Batch output must be at least as long as batch input.");
+}
+
+using kernelFn = void (*)(const double*, double*, std::size_t);
+
+/** Float arrays are widened in blocks, evaluated in double, and rounded back. */
+void floatLoop(std::span<const float> x, std::span<float> r, const kernelFn f) {
+    checkSize(x.size(), r.size());
+    constexpr std::size_t BLOCK = 256;
+    double buf[BLOCK];
+    for (std::size_t i=0; i<x.size(); i+=BLOCK) {
+        const std::size_t n = std::min(BLOCK, x.size()-i);
+        for (std::size_t j=0; j<n; ++j) {buf[j] = x[i+j];}
+        f(buf, buf, n);
+        for (std::size_t j=0; j<n; ++j) {r[i+j] = static_cast<float>(buf[j]);}
+    }
+}
+
+}   // namespace
+
+
+simdISA simdSupported() noexcept {
+    return supported;
+}
+
+simdISA simdActive() noexcept {
+    return active.load(std::memory_order_relaxed);
+}
+
+simdISA simdSelect(simdISA isa) noexcept {
+    if (isa > supported) isa = supported;
+    active.store(isa, std::memory_order_relaxed);
+    return isa;
+}
+
+
+void vecExp(std::span<const double> x, std::span<double> r) {
+    checkSize(x.size(), r.size());
+    kernels().exp(x.data(), r.data(), x.size());
+}
+
+void vecLog(std::span<const double> x, std::span<double> r) {
+    checkSize(x.size(), r.size());
+    kernels().log(x.data(), r.data(), x.size());
+}
+
+void vecErf(std::span<const double> x, std::span<double> r) {
+    checkSize(x.size(), r.size());
+    kernels().erf(x.data(), r.data(), x.size());
+}
+
+void vecErfc(std::span<const double> x, std::span<double> r) {
+    checkSize(x.size(), r.size());
+    kernels().erfc(x.data(), r.data(), x.size());
+}
+
+void vecAtan(std::span<const double> x, std::span<double> r) {
+    checkSize(x.size(), r.size());
+    kernels().atan(x.data(), r.data(), x.size());
+}
+
+void vecExp (std::span<const float> x, std::span<float> r) {floatLoop(x, r, kernels().exp);}
+void vecLog (std::span<const float> x, std::span<float> r) {floatLoop(x, r, kernels().log);}
+void vecErf (std::span<const float> x, std::span<float> r) {floatLoop(x, r, kernels().erf);}
+void vecErfc(std::span<const float> x, std::span<float> r) {floatLoop(x, r, kernels().erfc);}
+void vecAtan(std::span<const float> x, std::span<float> r) {floatLoop(x, r, kernels().atan);}
+
+void vecPow(std::span<const double> x, std::span<const double> y, std::span<double> r) {
+    checkSize(x.size(), r.size());
+    checkSize(x.size(), y.size());
+    kernels().pow(x.data(), y.data(), r.data(), x.size());
+}
+
+void vecPow(std::span<const double> x, const double y, std::span<double> r) {
+    checkSize(x.size(), r.size());
+    kernels().pows(x.data(), y, r.data(), x.size());
+}
+
+void vecPhilox(std::uint64_t key, std::uint64_t stream, std::uint64_t first, std::span<std::uint64_t> r) {
+    if (r.size() % 2)
+        throw std::invalid_argument("Philox output holds whole blocks of two words.");
+    kernels().philox(key, stream, first, r.data(), r.size()/2);
+}
+
+}   // namespace statanaly
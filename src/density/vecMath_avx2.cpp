@@ -0,0 +1,105 @@
+/*
+   Copyright 2022, Ansel Blumers
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "vecMath_dispatch.h"
+
+#if defined(__AVX2__) && defined(__FMA__)
+
+#include <immintrin.h>
+#include "vecMath_kernels.h"
+
+namespace statanaly {
+namespace {
+
+/** Four doubles in an AVX2 register, with hardware FMA. */
+struct packAVX2 {
+    using V = __m256d;
+    using M = __m256d;
+    static constexpr int N = 4;
+    static constexpr int FULL = 0xF;
+
+    static V load(const double* p)          { return _mm256_loadu_pd(p); }
+    static void store(double* p, const V v) { _mm256_storeu_pd(p, v); }
+    static V set1(const double a)           { return _mm256_set1_pd(a); }
+
+    static V add(const V a, const V b) { return _mm256_add_pd(a, b); }
+    static V sub(const V a, const V b) { return _mm256_sub_pd(a, b); }
+    static V mul(const V a, const V b) { return _mm256_mul_pd(a, b); }
+    static V div(const V a, const V b) { return _mm256_div_pd(a, b); }
+    static V fma(const V a, const V b, const V c) { return _mm256_fmadd_pd(a, b, c); }
+    static V prodErr(const V a, const V b, const V p) { return _mm256_fmsub_pd(a, b, p); }
+
+    static V andBits(const V a, const V b) { return _mm256_and_pd(a, b); }
+    static V orBits (const V a, const V b) { return _mm256_or_pd(a, b); }
+    static V xorBits(const V a, const V b) { return _mm256_xor_pd(a, b); }
+    static V abs(const V a) { return _mm256_andnot_pd(set1(-0.), a); }
+    static V trunc27(const V a) {
+        return andBits(a, _mm256_castsi256_pd(_mm256_set1_epi64x(static_cast<long long>(0xFFFFFFFFF8000000ull))));
+    }
+
+    static M lt(const V a, const V b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+    static M le(const V a, const V b) { return _mm256_cmp_pd(a, b, _CMP_LE_OQ); }
+    static M gt(const V a, const V b) { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+    static M ge(const V a, const V b) { return _mm256_cmp_pd(a, b, _CMP_GE_OQ); }
+    static M mand(const M a, const M b) { return _mm256_and_pd(a, b); }
+    static M mor (const M a, const M b) { return _mm256_or_pd(a, b); }
+    static M mnot(const M a) { return _mm256_xor_pd(a, _mm256_castsi256_pd(_mm256_set1_epi64x(-1))); }
+    static V select(const M m, const V a, const V b) { return _mm256_blendv_pd(b, a, m); }
+    static int bits(const M m) { return _mm256_movemask_pd(m); }
+
+    static V roundInt(const V a) {
+        const V magic = set1(0x1.8p52);
+        return sub(add(a, magic), magic);
+    }
+    static V pow2i(const V k) {
+        const __m256i i = _mm256_castpd_si256(add(k, set1(0x1.8p52)));
+        return _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_add_epi64(i, _mm256_set1_epi64x(1023)), 52));
+    }
+    static V exponent(const V a) {
+        const __m256i e = _mm256_srli_epi64(_mm256_castpd_si256(a), 52);
+        const V t = _mm256_or_pd(_mm256_castsi256_pd(e), set1(0x1p52));
+        return sub(t, set1(0x1p52 + 1023));
+    }
+    static V mantissa(const V a) {
+        const V m = andBits(a, _mm256_castsi256_pd(_mm256_set1_epi64x(0x000FFFFFFFFFFFFFll)));
+        return orBits(m, set1(1.));
+    }
+
+    using I = __m256i;
+    static I iload(const std::uint64_t* p)        { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static void istore(std::uint64_t* p, const I v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+    static I iset1(const std::uint64_t a)          { return _mm256_set1_epi64x(static_cast<long long>(a)); }
+    static I iadd(const I a, const I b) { return _mm256_add_epi64(a, b); }
+    static I iand(const I a, const I b) { return _mm256_and_si256(a, b); }
+    static I ior (const I a, const I b) { return _mm256_or_si256(a, b); }
+    static I ixor(const I a, const I b) { return _mm256_xor_si256(a, b); }
+    static I ishl32(const I a) { return _mm256_slli_epi64(a, 32); }
+    static I ishr32(const I a) { return _mm256_srli_epi64(a, 32); }
+    static I imul32(const I a, const I b) { return _mm256_mul_epu32(a, b); }
+};
+
+}   // namespace
+
+const vecMathKernels* vecMathAVX2() { return vmTable<packAVX2>(); }
+
+}   // namespace statanaly
+
+#else
+
+namespace statanaly {
+const vecMathKernels* vecMathAVX2() { return nullptr; }
+}   // namespace statanaly
+
+#endif
@@ -0,0 +1,120 @@
+/*
+   Copyright 2022, Ansel Blumers
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "vecMath_dispatch.h"
+
+#if defined(__AVX512F__)
+
+#include <immintrin.h>
+#include "vecMath_kernels.h"
+
+// GCC's avx512fintrin.h builds some intrinsics from a deliberately
+// undefined register (__Y), which -W(maybe-)uninitialized flags once inlined.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+namespace statanaly {
+namespace {
+
+/** Eight doubles in an AVX-512 register. Restricted to AVX-512F instructions. */
+struct packAVX512 {
+    using V = __m512d;
+    using M = __mmask8;
+    static constexpr int N = 8;
+    static constexpr int FULL = 0xFF;
+
+    static V load(const double* p)          { return _mm512_loadu_pd(p); }
+    static void store(double* p, const V v) { _mm512_storeu_pd(p, v); }
+    static V set1(const double a)           { return _mm512_set1_pd(a); }
+
+    static V add(const V a, const V b) { return _mm512_add_pd(a, b); }
+    static V sub(const V a, const V b) { return _mm512_sub_pd(a, b); }
+    static V mul(const V a, const V b) { return _mm512_mul_pd(a, b); }
+    static V div(const V a, const V b) { return _mm512_div_pd(a, b); }
+    static V fma(const V a, const V b, const V c) { return _mm512_fmadd_pd(a, b, c); }
+    static V prodErr(const V a, const V b, const V p) { return _mm512_fmsub_pd(a, b, p); }
+
+    static __m512i i(const V a) { return _mm512_castpd_si512(a); }
+    static V d(const __m512i a) { return _mm512_castsi512_pd(a); }
+
+    static V andBits(const V a, const V b) { return d(_mm512_and_epi64(i(a), i(b))); }
+    static V orBits (const V a, const V b) { return d(_mm512_or_epi64(i(a), i(b))); }
+    static V xorBits(const V a, const V b) { return d(_mm512_xor_epi64(i(a), i(b))); }
+    static V abs(const V a) { return d(_mm512_and_epi64(i(a), _mm512_set1_epi64(0x7FFFFFFFFFFFFFFFll))); }
+    static V trunc27(const V a) {
+        return d(_mm512_and_epi64(i(a), _mm512_set1_epi64(static_cast<long long>(0xFFFFFFFFF8000000ull))));
+    }
+
+    static M lt(const V a, const V b) { return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ); }
+    static M le(const V a, const V b) { return _mm512_cmp_pd_mask(a, b, _CMP_LE_OQ); }
+    static M gt(const V a, const V b) { return _mm512_cmp_pd_mask(a, b, _CMP_GT_OQ); }
+    static M ge(const V a, const V b) { return _mm512_cmp_pd_mask(a, b, _CMP_GE_OQ); }
+    static M mand(const M a, const M b) { return M(a & b); }
+    static M mor (const M a, const M b) { return M(a | b); }
+    static M mnot(const M a) { return M(~a); }
+    static V select(const M m, const V a, const V b) { return _mm512_mask_blend_pd(m, b, a); }
+    static int bits(const M m) { return int(m); }
+
+    static V roundInt(const V a) {
+        const V magic = set1(0x1.8p52);
+        return sub(add(a, magic), magic);
+    }
+    static V pow2i(const V k) {
+        const __m512i t = i(add(k, set1(0x1.8p52)));
+        return d(_mm512_slli_epi64(_mm512_add_epi64(t, _mm512_set1_epi64(1023)), 52));
+    }
+    static V exponent(const V a) {
+        const __m512i e = _mm512_srli_epi64(i(a), 52);
+        const V t = orBits(d(e), set1(0x1p52));
+        return sub(t, set1(0x1p52 + 1023));
+    }
+    static V mantissa(const V a) {
+        const V m = andBits(a, d(_mm512_set1_epi64(0x000FFFFFFFFFFFFFll)));
+        return orBits(m, set1(1.));
+    }
+
+    using I = __m512i;
+    static I iload(const std::uint64_t* p)        { return _mm512_loadu_si512(p); }
+    static void istore(std::uint64_t* p, const I v) { _mm512_storeu_si512(p, v); }
+    static I iset1(const std::uint64_t a)          { return _mm512_set1_epi64(static_cast<long long>(a)); }
+    static I iadd(const I a, const I b) { return _mm512_add_epi64(a, b); }
+    static I iand(const I a, const I b) { return _mm512_and_epi64(a, b); }
+    static I ior (const I a, const I b) { return _mm512_or_epi64(a, b); }
+    static I ixor(const I a, const I b) { return _mm512_xor_epi64(a, b); }
+    static I ishl32(const I a) { return _mm512_slli_epi64(a, 32); }
+    static I ishr32(const I a) { return _mm512_srli_epi64(a, 32); }
+    static I imul32(const I a, const I b) { return _mm512_mul_epu32(a, b); }
+};
+
+}   // namespace
+
+const vecMathKernels* vecMathAVX512() { return vmTable<packAVX512>(); }
+
+}   // namespace statanaly
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#else
+
+namespace statanaly {
+const vecMathKernels* vecMathAVX512() { return nullptr; }
+}   // namespace statanaly
+
+#endif
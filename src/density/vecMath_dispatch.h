@@ -0,0 +1,52 @@
+/*
+   Copyright 2022, Ansel Blumers
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef STATANALY_VEC_MATH_DISPATCH_H_
+#define STATANALY_VEC_MATH_DISPATCH_H_
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file vecMath_dispatch.h
+ * @brief Internal kernel table of the vectorized math layer.
+ *
+ * Every instruction set is compiled in its own translation unit
+ * (vecMath_sse2.cpp, vecMath_avx2.cpp, vecMath_avx512.cpp) with the
+ * matching compiler flags, and exposes one table of function pointers.
+ * vecMath.cpp picks the table at runtime.
+ */
+
+namespace statanaly {
+
+struct vecMathKernels {
+    void (*exp) (const double* x, double* r, std::size_t n);
+    void (*log) (const double* x, double* r, std::size_t n);
+    void (*erf) (const double* x, double* r, std::size_t n);
+    void (*erfc)(const double* x, double* r, std::size_t n);
+    void (*atan)(const double* x, double* r, std::size_t n);
+    void (*pow) (const double* x, const double* y, double* r, std::size_t n);
+    void (*pows)(const double* x, const double y, double* r, std::size_t n);
+    void (*philox)(std::uint64_t key, std::uint64_t stream, std::uint64_t first, std::uint64_t* r, std::size_t nBlocks);
+};
+
+/** Kernel tables. nullptr when the instruction set was not compiled in. */
+const vecMathKernels* vecMathSSE2();
+const vecMathKernels* vecMathAVX2();
+const vecMathKernels* vecMathAVX512();
+
+}   // namespace statanaly
+
+#endif
@@ -0,0 +1,454 @@
+/*
+   Copyright 2022, Ansel Blumers
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#ifndef STATANALY_VEC_MATH_KERNELS_H_
+#define STATANALY_VEC_MATH_KERNELS_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <math.h>
+#include "vecMath_dispatch.h"
+
+/**
+ * @file vecMath_kernels.h
+ * @brief Vectorized exp, log, erf, erfc, atan, pow and Philox, written once for all instruction sets.
+ *
+ * The kernels are templates over a "pack" P that wraps the registers of one
+ * instruction set. P provides:
+ *
+ *      V, M, N, FULL                         register, mask, lanes, all-lanes mask bits
+ *      load store set1                       memory
+ *      add sub mul div fma prodErr           arithmetic (prodErr(a,b,p) == a*b-p exactly)
+ *      abs andBits orBits xorBits            bit manipulation
+ *      lt le gt ge mand mor mnot select bits comparison and blending
+ *      roundInt pow2i exponent mantissa      float <-> integer tricks
+ *      I iload istore iset1                  64-bit integer lanes
+ *      iadd iand ior ixor ishl32 ishr32      integer arithmetic
+ *      imul32                                32x32->64 product of the low halves
+ *
+ * Lanes a kernel cannot handle (NaN, Inf, subnormal, overflow, ...) are
+ * flagged in a mask and recomputed with libm, so the vector code only needs
+ * to be right on the common range.
+ *
+ * Only included by the vecMath_<isa>.cpp files. Everything lives in an
+ * anonymous namespace: these translation units are compiled with different
+ * instruction sets, and a shared inline definition could be folded into the
+ * copy that uses the widest one.
+ */
+
+namespace statanaly {
+namespace {
+
+/* Coefficients -------------------------------------------- */
+
+constexpr double VM_LN2_HI = 6.93147180369123816490e-01;    // 32 significant bits
+constexpr double VM_LN2_LO = 1.90821492927058770002e-10;
+constexpr double VM_LOG2E  = 1.44269504088896340736e+00;
+constexpr double VM_SQRT2  = 1.41421356237309504880e+00;
+constexpr double VM_DBL_MIN = 2.2250738585072014e-308;
+constexpr double VM_DBL_MAX = 1.7976931348623157e+308;
+
+template<int K>
+struct vmCoef { double c[K]; };
+
+/** exp(r) = sum r^k/k! on |r| <= ln2/2. Degree 13 is below 1e-17. */
+constexpr auto vmExpCoef = []{
+    vmCoef<14> t{};
+    double f = 1;
+    for (int k=0; k<14; ++k) {
+        if (k>1) f *= k;
+        t.c[k] = 1/f;
+    }
+    return t;
+}();
+
+/** log(1+f) = f - f^2/2 + s*(f^2/2 + R(s^2)), s = f/(2+f), R(z) = sum_k 2 z^k/(2k+1). */
+constexpr auto vmLogCoef = []{
+    vmCoef<10> t{};
+    for (int k=1; k<=10; ++k) {t.c[k-1] = 2./(2*k+1);}
+    return t;
+}();
+
+/** erf(x) = x * sum_n 2/sqrt(pi) (-1)^n x^2n / (n! (2n+1)) on |x| < 0.75. */
+constexpr auto vmErfCoef = []{
+    vmCoef<16> t{};
+    double f = 1;
+    for (int n=0; n<16; ++n) {
+        if (n>0) f *= n;
+        t.c[n] = (n%2 ? -1. : 1.) * 1.12837916709551257390 / (f * (2*n+1));
+    }
+    return t;
+}();
+
+/** Chebyshev coefficients of log(erfc(z)/t) + z^2 in ty = 4t-2, t = 2/(2+z). */
+constexpr double vmErfcCheb[28] = {
+    -1.302653719781709434249e+00,  6.419697923564902603075e-01,
+     1.947647320418583626782e-02, -9.561514786808631552956e-03,
+    -9.465953444820369652675e-04,  3.668394978527615794110e-04,
+     4.252332480690770388797e-05, -2.027857811253420115306e-05,
+    -1.624290004647026709097e-06,  1.303655835580537296847e-06,
+     1.562644172203950937374e-08, -8.523809591489902876946e-08,
+     6.529054439189719595387e-09,  5.059343495555533240515e-09,
+    -9.913641563289972771991e-10, -2.273651220232155226175e-10,
+     9.646791097330745940161e-11,  2.394038146977944814253e-12,
+    -6.886027268141955981326e-12,  8.944878854538068635646e-13,
+     3.130924176603794295461e-13, -1.127080552368667221140e-13,
+     3.812949305251334131080e-16,  7.105798696845078143672e-15,
+    -1.523203763641178820640e-15, -9.506826749439145629354e-17,
+     1.216664572908920938280e-16, -2.854433269611211798573e-17,
+};
+
+/** atan rational approximation on [0, 0.66] (Cephes). */
+constexpr double vmAtanP[5] = {
+    -8.750608600031904122785e-01, -1.615753718733365076637e+01,
+    -7.500855792314704667340e+01, -1.228866684490136173410e+02,
+    -6.485021904942025371773e+01,
+};
+constexpr double vmAtanQ[5] = {
+     2.485846490142306297962e+01,  1.650270098316988542046e+02,
+     4.328810604912902668951e+02,  4.853903996359136964868e+02,
+     1.945506571482613964425e+02,
+};
+constexpr double VM_ATAN_MOREBITS = 6.123233995736765886130e-17;
+
+
+/* Kernels ------------------------------------------------- */
+
+template<class P>
+struct vmKernels {
+    using V = typename P::V;
+    using M = typename P::M;
+
+    template<int K>
+    static V horner(const V z, const vmCoef<K>& t) {
+        V p = P::set1(t.c[K-1]);
+        for (int k=K-2; k>=0; --k) {p = P::fma(p, z, P::set1(t.c[k]));}
+        return p;
+    }
+
+    /** exp(hi+lo) for |hi+lo| <= 708, lo being a small correction to hi. */
+    static V expk(const V hi, const V lo) {
+        const V k = P::roundInt(P::mul(P::add(hi, lo), P::set1(VM_LOG2E)));
+        V r = P::fma(k, P::set1(-VM_LN2_HI), hi);
+        r = P::add(P::fma(k, P::set1(-VM_LN2_LO), r), lo);
+        return P::mul(horner(r, vmExpCoef), P::pow2i(k));
+    }
+
+    /** Split a positive normal x into 2^e * (1+f) with 1+f in [sqrt(1/2), sqrt(2)). */
+    static void logSplit(const V x, V& e, V& f) {
+        V m = P::mantissa(x);
+        e = P::exponent(x);
+        const M big = P::gt(m, P::set1(VM_SQRT2));
+        m = P::select(big, P::mul(m, P::set1(0.5)), m);
+        e = P::select(big, P::add(e, P::set1(1.)), e);
+        f = P::sub(m, P::set1(1.));
+    }
+
+    /** log(x) for positive normal x. */
+    static V logk(const V x) {
+        V e, f;
+        logSplit(x, e, f);
+        const V s = P::div(f, P::add(P::set1(2.), f));
+        const V z = P::mul(s, s);
+        const V R = P::mul(z, horner(z, vmLogCoef));
+        const V hfsq = P::mul(P::set1(0.5), P::mul(f, f));
+        // e*ln2_hi - ((hfsq - (s*(hfsq+R) + e*ln2_lo)) - f)
+        const V t = P::fma(s, P::add(hfsq, R), P::mul(e, P::set1(VM_LN2_LO)));
+        return P::fma(e, P::set1(VM_LN2_HI), P::sub(f, P::sub(hfsq, t)));
+    }
+
+    /** log(x) = hi + lo in double-double precision, for positive normal x. */
+    static void logkDD(const V x, V& hi, V& lo) {
+        V e, f;
+        logSplit(x, e, f);
+        const V s = P::div(f, P::add(P::set1(2.), f));
+        const V z = P::mul(s, s);
+        const V R = P::mul(z, horner(z, vmLogCoef));
+        const V ff = P::mul(f, f);
+        const V hfsq = P::mul(P::set1(0.5), ff);
+        const V hfsqErr = P::mul(P::set1(0.5), P::prodErr(f, f, ff));
+        const V t = P::mul(s, P::add(hfsq, R));
+
+        // a + aErr = f - hfsq, exactly.
+        const V a = P::sub(f, hfsq);
+        const V av = P::sub(a, f);
+        const V aErr = P::sub(P::sub(f, P::sub(a, av)), P::add(hfsq, av));
+        const V l = P::add(P::sub(aErr, hfsqErr), t);
+
+        // h + hErr = e*ln2_hi + a, exactly.
+        const V kh = P::mul(e, P::set1(VM_LN2_HI));
+        const V h = P::add(kh, a);
+        const V hv = P::sub(h, kh);
+        const V hErr = P::add(P::sub(kh, P::sub(h, hv)), P::sub(a, hv));
+        const V L = P::add(P::add(hErr, l), P::mul(e, P::set1(VM_LN2_LO)));
+
+        hi = P::add(h, L);
+        lo = P::sub(L, P::sub(hi, h));
+    }
+
+    /** erf(x) for |x| < 0.75. */
+    static V erfSmall(const V x) {
+        return P::mul(x, horner(P::mul(x, x), vmErfCoef));
+    }
+
+    /** erfc(z) for 0 <= z <= 26. */
+    static V erfcLarge(const V z) {
+        const V t = P::div(P::set1(2.), P::add(P::set1(2.), z));
+        const V ty = P::fma(P::set1(4.), t, P::set1(-2.));
+        V d = P::set1(0.), dd = P::set1(0.);
+        for (int j=27; j>0; --j) {
+            const V tmp = d;
+            d = P::add(P::fma(ty, d, P::set1(vmErfcCheb[j])), P::sub(P::set1(0.), dd));
+            dd = tmp;
+        }
+        const V ch = P::sub(P::mul(P::set1(0.5), P::fma(ty, d, P::set1(vmErfcCheb[0]))), dd);
+
+        // z^2 = zh^2 + (z-zh)*(z+zh), where zh^2 is exact.
+        const V zh = P::trunc27(z);
+        const V hi = P::sub(P::set1(0.), P::mul(zh, zh));
+        const V lo = P::sub(ch, P::mul(P::sub(z, zh), P::add(z, zh)));
+        return P::mul(t, expk(hi, lo));
+    }
+
+    static V exp(const V x, M& fix) {
+        fix = P::mnot(P::le(P::abs(x), P::set1(708.)));
+        return expk(x, P::set1(0.));
+    }
+
+    static V log(const V x, M& fix) {
+        fix = P::mnot(P::mand(P::ge(x, P::set1(VM_DBL_MIN)), P::le(x, P::set1(VM_DBL_MAX))));
+        return logk(x);
+    }
+
+    static V erf(const V x, M& fix) {
+        const V a = P::abs(x);
+        const M small = P::lt(a, P::set1(0.75));
+        fix = P::mnot(P::le(a, P::set1(26.)));
+        if (P::bits(small) == P::FULL) return erfSmall(x);
+
+        const V sgn = P::xorBits(x, a);
+        const V big = P::orBits(P::sub(P::set1(1.), erfcLarge(a)), sgn);
+        if (P::bits(small) == 0) return big;
+        return P::select(small, erfSmall(x), big);
+    }
+
+    static V erfc(const V x, M& fix) {
+        const V a = P::abs(x);
+        const M small = P::lt(a, P::set1(0.75));
+        fix = P::mnot(P::le(a, P::set1(26.)));
+        if (P::bits(small) == P::FULL) return P::sub(P::set1(1.), erfSmall(x));
+
+        const V e = erfcLarge(a);
+        const V big = P::select(P::lt(x, P::set1(0.)), P::sub(P::set1(2.), e), e);
+        if (P::bits(small) == 0) return big;
+        return P::select(small, P::sub(P::set1(1.), erfSmall(x)), big);
+    }
+
+    static V atan(const V x, M& fix) {
+        fix = P::lt(x, x);      // never: atan is exact on NaN and Inf as well.
+
+        const V a = P::abs(x);
+        const V sgn = P::xorBits(x, a);
+        const M far  = P::gt(a, P::set1(2.41421356237309504880));     // tan(3pi/8)
+        const M near = P::mand(P::mnot(far), P::gt(a, P::set1(0.66)));
+
+        const V one = P::set1(1.);
+        V y = P::select(far, P::set1(M_PI_2), P::select(near, P::set1(M_PI_4), P::set1(0.)));
+        const V more = P::select(far, P::set1(VM_ATAN_MOREBITS),
+            P::select(near, P::set1(0.5*VM_ATAN_MOREBITS), P::set1(0.)));
+        const V xr = P::select(far, P::div(P::set1(-1.), a),
+            P::select(near, P::div(P::sub(a, one), P::add(a, one)), a));
+
+        const V z = P::mul(xr, xr);
+        V p = P::set1(vmAtanP[0]);
+        for (int k=1; k<5; ++k) {p = P::fma(p, z, P::set1(vmAtanP[k]));}
+        V q = P::add(z, P::set1(vmAtanQ[0]));
+        for (int k=1; k<5; ++k) {q = P::fma(q, z, P::set1(vmAtanQ[k]));}
+
+        const V r = P::fma(xr, P::div(P::mul(z, p), q), xr);
+        y = P::add(y, P::add(r, more));
+        return P::orBits(y, sgn);
+    }
+
+    static V pow(const V x, const V y, M& fix) {
+        fix = P::mnot(P::mand(
+            P::mand(P::ge(x, P::set1(VM_DBL_MIN)), P::le(x, P::set1(VM_DBL_MAX))),
+            P::le(P::abs(y), P::set1(VM_DBL_MAX))));
+
+        V hi, lo;
+        logkDD(x, hi, lo);
+        const V p = P::mul(y, hi);
+        const V pErr = P::fma(y, lo, P::prodErr(y, hi, p));
+        fix = P::mor(fix, P::mnot(P::le(P::abs(p), P::set1(708.))));
+        return expk(p, pErr);
+    }
+};
+
+
+/* Philox4x32-10 ------------------------------------------- */
+
+constexpr std::uint32_t VM_PHILOX_M0 = 0xD2511F53;
+constexpr std::uint32_t VM_PHILOX_M1 = 0xCD9E8D57;
+constexpr std::uint32_t VM_PHILOX_W0 = 0x9E3779B9;
+constexpr std::uint32_t VM_PHILOX_W1 = 0xBB67AE85;
+
+/**
+ * Blocks first, ..., first+nBlocks-1, P::N at a time. Each 32-bit word of
+ * the state sits in the low half of a 64-bit lane, so imul32 does the
+ * Philox multiplications of N blocks at once.
+ */
+template<class P>
+inline void vmPhilox(const std::uint64_t key, const std::uint64_t stream, const std::uint64_t first,
+    std::uint64_t* r, const std::size_t nBlocks) {
+    using I = typename P::I;
+    std::uint64_t iota[P::N];
+    for (int j=0; j<P::N; ++j) {iota[j] = j;}
+    const I lo = P::iset1(0xFFFFFFFFu);
+    const I m0 = P::iset1(VM_PHILOX_M0);
+    const I m1 = P::iset1(VM_PHILOX_M1);
+    const I s0 = P::iset1(stream & 0xFFFFFFFFu);
+    const I s1 = P::iset1(stream >> 32);
+
+    std::uint64_t w0[P::N], w1[P::N];
+    for (std::size_t i=0; i<nBlocks; i+=P::N) {
+        const I ctr = P::iadd(P::iset1(first + i), P::iload(iota));
+        I c0 = P::iand(ctr, lo), c1 = P::ishr32(ctr), c2 = s0, c3 = s1;
+        std::uint32_t k0 = std::uint32_t(key), k1 = std::uint32_t(key >> 32);
+        for (int round=0; round<10; ++round, k0+=VM_PHILOX_W0, k1+=VM_PHILOX_W1) {
+            const I p0 = P::imul32(c0, m0);
+            const I p1 = P::imul32(c2, m1);
+            c0 = P::ixor(P::ixor(P::ishr32(p1), c1), P::iset1(k0));
+            c1 = P::iand(p1, lo);
+            c2 = P::ixor(P::ixor(P::ishr32(p0), c3), P::iset1(k1));
+            c3 = P::iand(p0, lo);
+        }
+        P::istore(w0, P::ior(P::ishl32(c1), c0));
+        P::istore(w1, P::ior(P::ishl32(c3), c2));
+        const std::size_t n = std::min<std::size_t>(P::N, nBlocks-i);
+        for (std::size_t j=0; j<n; ++j) {
+            r[2*(i+j)]   = w0[j];
+            r[2*(i+j)+1] = w1[j];
+        }
+    }
+}
+
+
+/* Drivers ------------------------------------------------- */
+
+/** Run a one-argument kernel over an array; flagged lanes fall back to libm. */
+template<class P, class Kernel>
+inline void vmRun(const double* x, double* r, std::size_t n, Kernel kernel, double (*libm)(double)) {
+    using V = typename P::V;
+    using M = typename P::M;
+
+    auto step = [&](const double* xi, double* ri, const int lanes) {
+        const V v = P::load(xi);
+        M fix;
+        const V res = kernel(v, fix);
+        int b = P::bits(fix);
+        if (b == 0) {
+            P::store(ri, res);
+            return;
+        }
+        double xs[P::N];
+        P::store(xs, v);        // ri may alias xi.
+        P::store(ri, res);
+        for (; b; b &= b-1) {
+            const int j = __builtin_ctz(b);
+            if (j < lanes) ri[j] = libm(xs[j]);
+        }
+    };
+
+    std::size_t i = 0;
+    for (; i+P::N <= n; i+=P::N) {step(x+i, r+i, P::N);}
+    if (i == n) return;
+
+    double tx[P::N], tr[P::N];
+    const int rem = int(n-i);
+    for (int j=0; j<P::N; ++j) {tx[j] = j<rem ? x[i+j] : 1.;}
+    step(tx, tr, rem);
+    for (int j=0; j<rem; ++j) {r[i+j] = tr[j];}
+}
+
+/** Run a two-argument kernel over arrays; flagged lanes fall back to libm. */
+template<class P, class Kernel>
+inline void vmRun2(const double* x, const double* y, const bool yScalar,
+    double* r, std::size_t n, Kernel kernel, double (*libm)(double,double)) {
+    using V = typename P::V;
+    using M = typename P::M;
+
+    auto step = [&](const double* xi, const double* yi, double* ri, const int lanes) {
+        const V vx = P::load(xi);
+        const V vy = yScalar ? P::set1(*yi) : P::load(yi);
+        M fix;
+        const V res = kernel(vx, vy, fix);
+        int b = P::bits(fix);
+        if (b == 0) {
+            P::store(ri, res);
+            return;
+        }
+        double xs[P::N], ys[P::N];
+        P::store(xs, vx);
+        P::store(ys, vy);
+        P::store(ri, res);
+        for (; b; b &= b-1) {
+            const int j = __builtin_ctz(b);
+            if (j < lanes) ri[j] = libm(xs[j], ys[j]);
+        }
+    };
+
+    std::size_t i = 0;
+    for (; i+P::N <= n; i+=P::N) {step(x+i, yScalar ? y : y+i, r+i, P::N);}
+    if (i == n) return;
+
+    double tx[P::N], ty[P::N], tr[P::N];
+    const int rem = int(n-i);
+    for (int j=0; j<P::N; ++j) {
+        tx[j] = j<rem ? x[i+j] : 1.;
+        ty[j] = yScalar ? *y : (j<rem ? y[i+j] : 1.);
+    }
+    step(tx, ty, tr, rem);
+    for (int j=0; j<rem; ++j) {r[i+j] = tr[j];}
+}
+
+/** Build the kernel table of pack P. */
+template<class P>
+inline const vecMathKernels* vmTable() {
+    using K = vmKernels<P>;
+    static const vecMathKernels table = {
+        [](const double* x, double* r, std::size_t n) {
+            vmRun<P>(x, r, n, [](auto v, auto& m){ return K::exp(v, m); }, ::exp);},
+        [](const double* x, double* r, std::size_t n) {
+            vmRun<P>(x, r, n, [](auto v, auto& m){ return K::log(v, m); }, ::log);},
+        [](const double* x, double* r, std::size_t n) {
+            vmRun<P>(x, r, n, [](auto v, auto& m){ return K::erf(v, m); }, ::erf);},
+        [](const double* x, double* r, std::size_t n) {
+            vmRun<P>(x, r, n, [](auto v, auto& m){ return K::erfc(v, m); }, ::erfc);},
+        [](const double* x, double* r, std::size_t n) {
+            vmRun<P>(x, r, n, [](auto v, auto& m){ return K::atan(v, m); }, ::atan);},
+        [](const double* x, const double* y, double* r, std::size_t n) {
+            vmRun2<P>(x, y, false, r, n, [](auto a, auto b, auto& m){ return K::pow(a, b, m); }, ::pow);},
+        [](const double* x, const double y, double* r, std::size_t n) {
+            vmRun2<P>(x, &y, true, r, n, [](auto a, auto b, auto& m){ return K::pow(a, b, m); }, ::pow);},
+        vmPhilox<P>,
+    };
+    return &table;
+}
+
+}   // namespace
+}   // namespace statanaly
+
+#endif
@@ -0,0 +1,119 @@
+/*
+   Copyright 2022, Ansel Blumers
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "vecMath_dispatch.h"
+
+#if defined(__SSE2__)
+
+#include <emmintrin.h>
+#include "vecMath_kernels.h"
+
+namespace statanaly {
+namespace {
+
+/** Two doubles in an SSE2 register. No FMA: fma is mul+add, prodErr uses a Dekker split. */
+struct packSSE2 {
+    using V = __m128d;
+    using M = __m128d;
+    static constexpr int N = 2;
+    static constexpr int FULL = 0x3;
+
+    static V load(const double* p)          { return _mm_loadu_pd(p); }
+    static void store(double* p, const V v) { _mm_storeu_pd(p, v); }
+    static V set1(const double a)           { return _mm_set1_pd(a); }
+
+    static V add(const V a, const V b) { return _mm_add_pd(a, b); }
+    static V sub(const V a, const V b) { return _mm_sub_pd(a, b); }
+    static V mul(const V a, const V b) { return _mm_mul_pd(a, b); }
+    static V div(const V a, const V b) { return _mm_div_pd(a, b); }
+    static V fma(const V a, const V b, const V c) { return add(mul(a, b), c); }
+
+    static V split(const V a, V& lo) {
+        const V c = mul(set1(134217729.), a);        // 2^27+1
+        const V hi = sub(c, sub(c, a));
+        lo = sub(a, hi);
+        return hi;
+    }
+    static V prodErr(const V a, const V b, const V p) {
+        V al, bl;
+        const V ah = split(a, al);
+        const V bh = split(b, bl);
+        return add(mul(al, bl), add(mul(ah, bl), add(mul(al, bh), sub(mul(ah, bh), p))));
+    }
+
+    static V andBits(const V a, const V b) { return _mm_and_pd(a, b); }
+    static V orBits (const V a, const V b) { return _mm_or_pd(a, b); }
+    static V xorBits(const V a, const V b) { return _mm_xor_pd(a, b); }
+    static V abs(const V a) { return _mm_andnot_pd(set1(-0.), a); }
+    static V trunc27(const V a) {
+        return andBits(a, _mm_castsi128_pd(_mm_set1_epi64x(static_cast<long long>(0xFFFFFFFFF8000000ull))));
+    }
+
+    static M lt(const V a, const V b) { return _mm_cmplt_pd(a, b); }
+    static M le(const V a, const V b) { return _mm_cmple_pd(a, b); }
+    static M gt(const V a, const V b) { return _mm_cmpgt_pd(a, b); }
+    static M ge(const V a, const V b) { return _mm_cmpge_pd(a, b); }
+    static M mand(const M a, const M b) { return _mm_and_pd(a, b); }
+    static M mor (const M a, const M b) { return _mm_or_pd(a, b); }
+    static M mnot(const M a) { return _mm_xor_pd(a, _mm_castsi128_pd(_mm_set1_epi64x(-1))); }
+    static V select(const M m, const V a, const V b) {
+        return _mm_or_pd(_mm_and_pd(m, a), _mm_andnot_pd(m, b));
+    }
+    static int bits(const M m) { return _mm_movemask_pd(m); }
+
+    static V roundInt(const V a) {
+        const V magic = set1(0x1.8p52);
+        return sub(add(a, magic), magic);
+    }
+    static V pow2i(const V k) {
+        const __m128i i = _mm_castpd_si128(add(k, set1(0x1.8p52)));
+        return _mm_castsi128_pd(_mm_slli_epi64(_mm_add_epi64(i, _mm_set1_epi64x(1023)), 52));
+    }
+    static V exponent(const V a) {
+        const __m128i e = _mm_srli_epi64(_mm_castpd_si128(a), 52);
+        const V t = _mm_or_pd(_mm_castsi128_pd(e), set1(0x1p52));
+        return sub(t, set1(0x1p52 + 1023));
+    }
+    static V mantissa(const V a) {
+        const V m = andBits(a, _mm_castsi128_pd(_mm_set1_epi64x(0x000FFFFFFFFFFFFFll)));
+        return orBits(m, set1(1.));
+    }
+
+    using I = __m128i;
+    static I iload(const std::uint64_t* p)        { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    static void istore(std::uint64_t* p, const I v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+    static I iset1(const std::uint64_t a)          { return _mm_set1_epi64x(static_cast<long long>(a)); }
+    static I iadd(const I a, const I b) { return _mm_add_epi64(a, b); }
+    static I iand(const I a, const I b) { return _mm_and_si128(a, b); }
+    static I ior (const I a, const I b) { return _mm_or_si128(a, b); }
+    static I ixor(const I a, const I b) { return _mm_xor_si128(a, b); }
+    static I ishl32(const I a) { return _mm_slli_epi64(a, 32); }
+    static I ishr32(const I a) { return _mm_srli_epi64(a, 32); }
+    static I imul32(const I a, const I b) { return _mm_mul_epu32(a, b); }
+};
+
+}   // namespace
+
+const vecMathKernels* vecMathSSE2() { return vmTable<packSSE2>(); }
+
+}   // namespace statanaly
+
+#else
+
+namespace statanaly {
+const vecMathKernels* vecMathSSE2() { return nullptr; }
+}   // namespace statanaly
+
+#endif
@@ -0,0 +1,53 @@
+/*
+   Copyright 2022, Ansel Blumers
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "distrArena.h"
+
+namespace statanaly {
+
+namespace {
+
+thread_local distrArena* active = nullptr;
+
+}   // namespace
+
+
+distrArena::distrArena(const std::size_t initialSize, std::pmr::memory_resource* upstream)
+    : buf(initialSize, upstream) {}
+
+distrArena::~distrArena() {
+    release();
+}
+
+void distrArena::release() noexcept {
+    for (auto it = made.rbegin(); it != made.rend(); ++it) {(*it)->~probDistr();}
+    // Let go of the list's storage before the buffer frees it.
+    std::pmr::vector<probDistr*>(&buf).swap(made);
+    buf.release();
+}
+
+distrArena* distrArena::current() noexcept {
+    return active;
+}
+
+arenaScope::arenaScope(distrArena& arena) : prev(active) {
+    active = &arena;
+}
+
+arenaScope::~arenaScope() {
+    active = prev;
+}
+
+}   // namespace statanaly
@@ -0,0 +1,126 @@
+/*
+   Copyright 2022, Ansel Blumers
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "parallelSampler.h"
+#include "rand_num_gen.h"
+
+namespace statanaly {
+
+parallelSampler::parallelSampler(const unsigned threads)
+    : shares(threads ? threads : std::max(1u, std::thread::hardware_concurrency())) {
+    for (std::size_t i = 1; i < shares.size(); ++i) {
+        pool.push_back(std::make_unique<worker>());
+        worker& w = *pool.back();
+        w.th = std::thread([this, i, &w](){
+            for (;;) {
+                w.go.acquire();
+                if (stop) return;
+                work(i);
+                done.release();
+            }
+        });
+    }
+}
+
+parallelSampler::~parallelSampler() {
+    stop = true;
+    for (auto& w : pool) {w->go.release();}
+    for (auto& w : pool) {w->th.join();}
+}
+
+bool parallelSampler::pop(const std::size_t i, std::size_t& c) {
+    std::lock_guard<std::mutex> lock(shares[i].m);
+    if (shares[i].lo == shares[i].hi) return false;
+    c = shares[i].lo++;
+    return true;
+}
+
+bool parallelSampler::steal(const std::size_t i) {
+    // Victim: the largest share. It may shrink before we take from it.
+    std::size_t victim = i, most = 0;
+    for (std::size_t j = 0; j < shares.size(); ++j) {
+        std::lock_guard<std::mutex> lock(shares[j].m);
+        if (shares[j].hi - shares[j].lo > most) {
+            most = shares[j].hi - shares[j].lo;
+            victim = j;
+        }
+    }
+    if (most == 0) return false;
+
+    std::size_t lo, hi;
+    {
+        std::lock_guard<std::mutex> lock(shares[victim].m);
+        const std::size_t left = shares[victim].hi - shares[victim].lo;
+        if (left == 0) return true;     // taken meanwhile; look again
+        hi = shares[victim].hi;
+        lo = hi - (left+1)/2;
+        shares[victim].hi = lo;
+    }
+    std::lock_guard<std::mutex> lock(shares[i].m);
+    shares[i].lo = lo;
+    shares[i].hi = hi;
+    return true;
+}
+
+void parallelSampler::work(const std::size_t i) {
+    try {
+        std::size_t c;
+        while (!failed) {
+            if (!pop(i, c)) {
+                if (!steal(i)) return;
+                continue;
+            }
+            const chunk& k = chunks[c];
+            rng_philox eng(key, std::uint64_t(k.job) << 32 | k.first/chunkSize);
+            jobs[k.job].distr->sample(eng, jobs[k.job].out.subspan(k.first, k.count));
+        }
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(errLock);
+        if (!failed.exchange(true)) err = std::current_exception();
+    }
+}
+
+void parallelSampler::run(std::span<const sampleJob> js, const std::uint64_t seed) {
+    std::lock_guard<std::mutex> lock(running);
+
+    chunks.clear();
+    for (std::size_t j = 0; j < js.size(); ++j) {
+        const std::size_t n = js[j].out.size();
+        if (std::uint64_t(n / chunkSize) >> 32)
+            throw std::invalid_argument("parallelSampler takes at most 2^32 chunks per job.");
+        for (std::size_t first = 0; first < n; first += chunkSize) {
+            chunks.push_back({j, first, std::min(chunkSize, n - first)});
+        }
+    }
+    if (chunks.empty()) return;
+
+    jobs = js;
+    key = seed;
+    failed = false;
+    err = nullptr;
+    const std::size_t T = shares.size();
+    for (std::size_t i = 0; i < T; ++i) {
+        shares[i].lo = chunks.size() * i / T;
+        shares[i].hi = chunks.size() * (i+1) / T;
+    }
+
+    for (auto& w : pool) {w->go.release();}
+    work(0);
+    for (std::size_t i = 0; i < pool.size(); ++i) {done.acquire();}
+
+    if (err) std::rethrow_exception(err);
+}
+
+}   // namespace statanaly
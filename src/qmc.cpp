@@ -0,0 +1,190 @@
+/*
+   Copyright 2022, Ansel Blumers
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "qmc.h"
+#include "rand_num_gen.h"
+#include <bit>
+
+namespace statanaly {
+
+namespace {
+
+/**
+ * Primitive polynomial x^s + a_1 x^(s-1) + ... + a_(s-1) x + 1, with a_1 the
+ * most significant bit of a, and the initial direction numbers m_1..m_s of
+ * dimensions 1 to maxDim-1. Dimension 0 is the van der Corput sequence.
+ */
+struct sobolInit {
+    unsigned s;
+    std::uint32_t a;
+    std::uint32_t m[9];
+};
+
+constexpr sobolInit sobolTable[sobol::maxDim-1] = {
+    {1,   0, {1}},
+    {2,   1, {1, 3}},
+    {3,   1, {1, 3, 1}},
+    {3,   2, {1, 1, 5}},
+    {4,   1, {1, 1, 7, 1}},
+    {4,   4, {1, 3, 7, 15}},
+    {5,   2, {1, 1, 7, 15, 25}},
+    {5,   4, {1, 1, 1, 7, 3}},
+    {5,   7, {1, 1, 3, 13, 21}},
+    {5,  11, {1, 1, 1, 11, 9}},
+    {5,  13, {1, 1, 3, 5, 19}},
+    {5,  14, {1, 3, 3, 15, 5}},
+    {6,   1, {1, 1, 7, 11, 31, 37}},
+    {6,  13, {1, 1, 5, 11, 3, 47}},
+    {6,  16, {1, 1, 5, 13, 9, 9}},
+    {6,  19, {1, 1, 1, 13, 5, 7}},
+    {6,  22, {1, 3, 5, 1, 13, 11}},
+    {6,  25, {1, 3, 7, 11, 23, 43}},
+    {7,   1, {1, 3, 7, 1, 5, 55, 31}},
+    {7,   4, {1, 1, 1, 13, 19, 35, 25}},
+    {7,   7, {1, 3, 7, 15, 11, 21, 41}},
+    {7,   8, {1, 3, 3, 11, 19, 39, 7}},
+    {7,  14, {1, 1, 5, 7, 17, 55, 23}},
+    {7,  19, {1, 3, 7, 15, 9, 13, 99}},
+    {7,  21, {1, 3, 3, 11, 29, 7, 27}},
+    {7,  28, {1, 3, 1, 7, 15, 13, 93}},
+    {7,  31, {1, 1, 3, 7, 17, 57, 31}},
+    {7,  32, {1, 3, 1, 1, 7, 51, 43}},
+    {7,  37, {1, 3, 7, 11, 1, 53, 119}},
+    {7,  41, {1, 3, 1, 11, 15, 17, 91}},
+    {7,  42, {1, 3, 1, 15, 3, 37, 71}},
+    {7,  50, {1, 3, 5, 1, 3, 59, 69}},
+    {7,  55, {1, 1, 5, 1, 23, 3, 99}},
+    {7,  56, {1, 3, 1, 15, 25, 5, 27}},
+    {7,  59, {1, 1, 5, 13, 31, 25, 45}},
+    {7,  62, {1, 1, 5, 3, 3, 47, 9}},
+    {8,  14, {1, 1, 1, 7, 21, 29, 57, 111}},
+    {8,  21, {1, 3, 7, 7, 21, 55, 89, 13}},
+    {8,  22, {1, 3, 3, 11, 9, 33, 31, 11}},
+    {8,  38, {1, 1, 1, 11, 5, 63, 89, 63}},
+    {8,  47, {1, 1, 7, 9, 3, 63, 17, 149}},
+    {8,  49, {1, 1, 1, 3, 15, 1, 107, 197}},
+    {8,  50, {1, 3, 7, 9, 25, 53, 127, 113}},
+    {8,  52, {1, 3, 5, 15, 5, 53, 29, 3}},
+    {8,  56, {1, 3, 1, 5, 25, 43, 115, 239}},
+    {8,  67, {1, 3, 1, 5, 1, 55, 103, 161}},
+    {8,  70, {1, 1, 5, 3, 9, 49, 99, 55}},
+    {8,  84, {1, 1, 3, 1, 9, 39, 127, 183}},
+    {8,  97, {1, 3, 1, 9, 25, 39, 101, 37}},
+    {8, 103, {1, 1, 3, 13, 25, 45, 25, 223}},
+    {8, 115, {1, 3, 7, 7, 21, 63, 23, 69}},
+    {8, 122, {1, 1, 5, 15, 27, 63, 11, 255}},
+    {9,   8, {1, 1, 5, 13, 13, 3, 43, 255, 183}},
+    {9,  13, {1, 3, 3, 7, 17, 5, 5, 247, 493}},
+    {9,  16, {1, 3, 3, 3, 11, 53, 13, 69, 31}},
+    {9,  22, {1, 1, 7, 7, 19, 15, 47, 3, 55}},
+    {9,  25, {1, 1, 3, 5, 27, 57, 35, 51, 275}},
+    {9,  44, {1, 3, 7, 13, 21, 13, 89, 203, 415}},
+    {9,  47, {1, 1, 7, 3, 31, 61, 79, 53, 31}},
+    {9,  52, {1, 3, 7, 13, 25, 55, 3, 95, 245}},
+    {9,  55, {1, 1, 7, 13, 19, 17, 119, 175, 245}},
+    {9,  59, {1, 1, 5, 11, 21, 51, 95, 95, 497}},
+    {9,  62, {1, 1, 3, 9, 23, 3, 103, 157, 257}},
+};
+
+}   // namespace
+
+
+sobol::sobol(const unsigned dim) : d(dim) {
+    build();
+    seek(0);
+}
+
+sobol::sobol(const unsigned dim, const std::uint64_t key, const std::uint64_t stream) : d(dim) {
+    build();
+
+    // Linear scramble: output bit r (from the top) is bit r of the input
+    // plus a random combination of the bits above it.
+    rng_philox eng(key, stream);
+    std::uint32_t L[32];
+    for (unsigned j = 0; j < d; ++j) {
+        for (int r = 0; r < 32; ++r) {
+            const std::uint32_t bit = std::uint32_t(1) << (31-r);
+            L[r] = (std::uint32_t(eng()) & ~(bit | (bit-1))) | bit;
+        }
+        for (int k = 0; k < 32; ++k) {
+            std::uint32_t w = 0;
+            for (int r = 0; r < 32; ++r) {
+                w |= std::uint32_t(std::popcount(L[r] & v[32*j+k]) & 1) << (31-r);
+            }
+            v[32*j+k] = w;
+        }
+    }
+
+    // Digital shift.
+    for (auto& c : shift) {c = std::uint32_t(eng());}
+    seek(0);
+}
+
+void sobol::build() {
+    if (d == 0 || d > maxDim)
+        throw std::invalid_argument("Sobol sequence takes between one and sobol::maxDim dimensions.");
+
+    v.assign(32*d, 0);
+    for (int k = 0; k < 32; ++k) {v[k] = std::uint32_t(1) << (31-k);}
+    for (unsigned j = 1; j < d; ++j) {
+        const sobolInit& t = sobolTable[j-1];
+        std::uint32_t m[33];
+        for (unsigned k = 1; k <= t.s; ++k) {m[k] = t.m[k-1];}
+        for (unsigned k = t.s+1; k <= 32; ++k) {
+            std::uint32_t w = m[k-t.s] ^ (m[k-t.s] << t.s);
+            for (unsigned i = 1; i < t.s; ++i) {
+                if (t.a >> (t.s-1-i) & 1) w ^= m[k-i] << i;
+            }
+            m[k] = w;
+        }
+        for (unsigned k = 1; k <= 32; ++k) {v[32*j+k-1] = m[k] << (32-k);}
+    }
+    shift.assign(d, 0);
+}
+
+void sobol::seek(const std::uint64_t i) {
+    if (i > maxPoints)
+        throw std::out_of_range("Sobol sequence has sobol::maxPoints points.");
+    n = i;
+    x = shift;
+    const std::uint64_t gray = i ^ (i >> 1);
+    for (int k = 0; k < 32; ++k) {
+        if (gray >> k & 1) {
+            for (unsigned j = 0; j < d; ++j) {x[j] ^= v[32*j+k];}
+        }
+    }
+}
+
+void sobol::next(std::span<double> u) {
+    next(1, u);
+}
+
+void sobol::next(const std::size_t count, std::span<double> u) {
+    if (u.size() < count*d)
+        throw std::invalid_argument("Sobol sequence needs room for count*dim() coordinates.");
+    if (count > maxPoints - n)
+        throw std::out_of_range("Sobol sequence has sobol::maxPoints points.");
+
+    for (std::size_t i = 0; i < count; ++i) {
+        for (unsigned j = 0; j < d; ++j) {u[j*count+i] = (x[j] + 0.5) * 0x1.0p-32;}
+        // Point n+1 differs from point n by the direction of the lowest zero bit of n.
+        const int k = std::countr_one(n++);
+        if (k < 32) {
+            for (unsigned j = 0; j < d; ++j) {x[j] ^= v[32*j+k];}
+        }
+    }
+}
+
+}   // namespace statanaly
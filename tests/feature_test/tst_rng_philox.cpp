@@ -0,0 +1,103 @@
+/*
+   Copyright 2022, Ansel Blumers
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "gtest/gtest.h"
+#include "rand_num_gen.h"
+#include "density/disNormal.h"
+#include <unordered_set>
+#include <vector>
+
+namespace statanaly {
+
+TEST(rng_philox, known_answer) {
+    // Random123 kat_vectors: philox4x32_10, counter and key zero.
+    rng_philox eng;
+    EXPECT_EQ( 0xe169c58d6627e8d5ull, eng() );
+    EXPECT_EQ( 0x9b00dbd8bc57ac4cull, eng() );
+}
+
+TEST(rng_philox, fill_matches_calls) {
+    rng_philox a(12345, 6), b(12345, 6);
+    std::vector<std::uint64_t> w(1000);
+    std::size_t at = 0;
+    // Odd sizes so that fill() starts and ends off the buffer boundary.
+    for (const std::size_t n : {3, 1, 40, 0, 17, 200, 5, 734}) {
+        a.fill(std::span<std::uint64_t>(w).subspan(at, n));
+        at += n;
+    }
+    ASSERT_EQ( w.size(), at );
+    for (std::size_t i=0; i<w.size(); i++) {
+        EXPECT_EQ( b(), w[i] ) << "word " << i;
+    }
+    EXPECT_TRUE( a == b );
+}
+
+TEST(rng_philox, discard) {
+    rng_philox a(7), b(7);
+    for (const std::uint64_t n : {0, 1, 5, 16, 31, 1000}) {
+        a.discard(n);
+        for (std::uint64_t i=0; i<n; i++) {b();}
+        EXPECT_EQ( b.position(), a.position() );
+        EXPECT_EQ( b(), a() );
+    }
+
+    // A jump far ahead is O(1).
+    rng_philox c(7, 1);
+    c.discard(std::uint64_t(1) << 60);
+    EXPECT_EQ( std::uint64_t(1) << 60, c.position() );
+}
+
+TEST(rng_philox, streams) {
+    const rng_philox root(0x0123456789abcdefull);
+    std::unordered_set<std::uint64_t> bag;
+    for (std::uint64_t id=0; id<64; id++) {
+        auto e = root.stream(id);
+        EXPECT_EQ( id, e.streamID() );
+        for (int i=0; i<32; i++) {bag.insert(e());}
+    }
+    EXPECT_EQ( 64u*32u, bag.size() );
+
+    // A stream is the same wherever it is made.
+    auto x = root.stream(42), y = rng_philox(0x0123456789abcdefull, 42);
+    for (int i=0; i<100; i++) {EXPECT_EQ( x(), y() );}
+}
+
+TEST(rng_philox, same_bits_on_every_isa) {
+    std::vector<std::uint64_t> ref(2*37);
+    simdSelect(simdISA::SCALAR);
+    rng_philox(99, 3).fill(ref);
+    for (const simdISA isa : {simdISA::SSE2, simdISA::AVX2, simdISA::AVX512}) {
+        if (simdSelect(isa) != isa) continue;
+        std::vector<std::uint64_t> w(ref.size());
+        rng_philox(99, 3).fill(w);
+        EXPECT_EQ( ref, w ) << "isa " << int(isa);
+    }
+    simdSelect(simdSupported());
+}
+
+TEST(rng_philox, as_engine) {
+    disNormal d(1, 2);
+    std::vector<double> r(500), q(500);
+    rng_philox a(5), b(5);
+    d.sample(a, r);
+    d.sample(b, q);
+    EXPECT_EQ( r, q );
+
+    double s = 0;
+    for (auto v : r) {s += v;}
+    EXPECT_NEAR( 1, s/r.size(), 0.3 );
+}
+
+}
@@ -15,7 +15,11 @@
 */
 #include "gtest/gtest.h"
 #include "rand_num_gen.h"
+#include "density/disNormal.h"
+#include <filesystem>
+#include <limits>
 #include <unordered_set>
+#include <vector>
 
 namespace statanaly {
 
@@ -31,4 +35,85 @@ TEST(rng_unix, get_random_numbers) {
     }
 }
 
+TEST(rng_unix, buffered_across_refills) {
+    // Small blocks so that the background thread refills many times.
+    std::size_t N = 5000;
+    rng_unix mygenerator(256);
+    EXPECT_TRUE( mygenerator.buffered() );
+    std::unordered_set<std::uint64_t> bag;
+    for (std::size_t i=0; i<N; i++) {
+        const auto v = mygenerator.getRN<std::uint64_t>();
+        EXPECT_FALSE( bag.contains(v) );
+        bag.insert(v);
+    }
+}
+
+TEST(rng_unix, fill_span) {
+    rng_unix mygenerator(1024);
+    // Smaller than a block, straddling blocks, and larger than a block.
+    for (const std::size_t N : {10, 300, 1000}) {
+        std::vector<std::uint64_t> v(N, 0);
+        mygenerator.fill(std::span<std::uint64_t>(v));
+        std::unordered_set<std::uint64_t> bag(v.begin(), v.end());
+        EXPECT_EQ( N, bag.size() );
+    }
+    // Odd sizes keep the stream byte-aligned.
+    unsigned char c[3];
+    mygenerator.fill(std::span<unsigned char>(c));
+    const auto a = mygenerator.getRN<std::uint64_t>();
+    const auto b = mygenerator.getRN<std::uint64_t>();
+    EXPECT_NE( a, b );
+}
+
+TEST(rng_unix, move) {
+    rng_unix a(512);
+    a.getRN<std::uint32_t>();
+    rng_unix b(std::move(a));
+    EXPECT_TRUE( b.buffered() );
+    EXPECT_LT( a.getFD(), 0 );
+
+    rng_unix c;
+    c = std::move(b);
+    EXPECT_TRUE( c.buffered() );
+    std::vector<std::uint64_t> v(200);
+    c.fill(std::span<std::uint64_t>(v));
+    std::unordered_set<std::uint64_t> bag(v.begin(), v.end());
+    EXPECT_EQ( v.size(), bag.size() );
+}
+
+TEST(rng_unix, destroyed_before_first_refill) {
+    // The refill grant from the constructor may still be pending at release.
+    for (int i = 0; i < 200; ++i) {
+        rng_unix mygenerator(64);
+    }
+    rng_unix mygenerator(64);
+    mygenerator.getRN<std::uint64_t>();
+}
+
+TEST(rng_unix, failed_construction_closes_fd) {
+    auto openFds = []{
+        return std::distance(std::filesystem::directory_iterator("/proc/self/fd"),
+                             std::filesystem::directory_iterator{});
+    };
+    const auto before = openFds();
+    EXPECT_THROW( rng_unix(std::numeric_limits<std::size_t>::max()), std::length_error );
+    EXPECT_EQ( before, openFds() );
+}
+
+TEST(rng_unix, as_engine) {
+    rng_unix mygenerator(rng_unix::defaultBlock);
+    disNormal d(1, 2);
+    std::vector<double> r(1000);
+    d.sample(mygenerator, r);
+    double s = 0;
+    for (auto v : r) {s += v;}
+    EXPECT_NEAR( 1, s/r.size(), 0.3 );
+
+    std::mt19937 eng;
+    setProperSeed(eng, mygenerator);
+    std::mt19937 other;
+    setProperSeed(other, mygenerator);
+    EXPECT_NE( eng(), other() );
+}
+
 }
\ No newline at end of file
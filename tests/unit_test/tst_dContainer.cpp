@@ -17,6 +17,11 @@
 #include "dContainer.h"
 #include "density/disNormal.h"
 #include "density/disUniform.h"
+#include "density/disExponential.h"
+#include "density/disNcChi.h"
+#include "density/disNcChiSq.h"
+#include "density/disRician.h"
+#include <random>
 
 namespace statanaly {
 
@@ -171,4 +176,156 @@ TEST( dContainer_Tests, rescale ) {
     }
 }
 
-}
\ No newline at end of file
+TEST( dContainer_Tests, alias_table ) {
+    // Each component's share of the table equals its weight.
+    dCtr c;
+    std::mt19937_64 eng(4);
+    std::uniform_real_distribution<double> w(0.01, 10.);
+    for (int i=0; i<1000; i++) {c.insert(disUniform(i, i+1), w(eng));}
+
+    const auto t = c.aliasTable();
+    EXPECT_EQ( t, c.aliasTable() );
+    ASSERT_EQ( 1000u, t->comp.size() );
+    std::vector<double> share(t->comp.size(), 0);
+    for (std::size_t i=0; i<t->comp.size(); i++) {
+        share[i] += t->prob[i];
+        share[t->alias[i]] += 1 - t->prob[i];
+    }
+    for (std::size_t i=0; i<t->comp.size(); i++) {
+        const auto it = c.get().find(const_cast<probDistr*>(t->comp[i]));
+        EXPECT_NEAR( it->second.second, share[i]/t->comp.size(), 1e-15 );
+    }
+
+    // The table is rebuilt after the weights change.
+    c.insert(disUniform(-1, 0), 5.);
+    EXPECT_NE( t, c.aliasTable() );
+    EXPECT_EQ( 1001u, c.aliasTable()->comp.size() );
+    c.clear();
+    EXPECT_EQ( 0u, c.aliasTable()->comp.size() );
+}
+
+TEST( dContainer_Tests, type_groups ) {
+    dCtr c;
+    c.insert(disNormal(0,1), 1.);
+    c.insert(disNormal(2,4), 3.);
+    c.insert(disUniform(0,2), 2.);
+    c.insert(disStdUniform(), 2.);
+    c.insert(disExponential(1.5), 2.);
+
+    const auto g = c.groups();
+    EXPECT_EQ( g, c.groups() );
+    EXPECT_EQ( 2u, g->normal.w.size() );
+    EXPECT_EQ( 2u, g->uniform.w.size() );
+    ASSERT_EQ( 1u, g->other.size() );
+    EXPECT_EQ( dFuncID::EXPONENTIAL_DISTR, g->other[0]->getID() );
+
+    double sum = 0;
+    for (const auto w : g->normal.w) {sum += w;}
+    for (const auto w : g->uniform.w) {sum += w;}
+    EXPECT_DOUBLE_EQ( 1, sum + g->otherW[0] );
+
+    // Rebuilt after the weights change.
+    c.insert(disNormal(1,1), 1.);
+    EXPECT_NE( g, c.groups() );
+    EXPECT_EQ( 3u, c.groups()->normal.w.size() );
+}
+
+TEST( dContainer_Tests, merge_duplicates ) {
+    dCtr c;
+    for (int i = 0; i < 1000; ++i) {
+        c.insert(disNormal(0,1), 1., true);
+        c.insert(disUniform(0,2), 3., true);
+    }
+    ASSERT_EQ( 2u, c.get().size() );
+    EXPECT_DOUBLE_EQ( 1000, c.find(disNormal(0,1))->second.first );
+    EXPECT_DOUBLE_EQ( 0.25, c.find(disNormal(0,1))->second.second );
+    EXPECT_DOUBLE_EQ( 0.75, c.find(disUniform(0,2))->second.second );
+
+    // Same weights as one insert each.
+    dCtr o;
+    o.insert(disNormal(0,1), 1.);
+    o.insert(disUniform(0,2), 3.);
+    EXPECT_DOUBLE_EQ( c.groups()->pdf(0.5), o.groups()->pdf(0.5) );
+
+    // Without merge, duplicates coexist; merging then adds to one of them.
+    c.insert(disNormal(0,1), 1000.);
+    EXPECT_EQ( 3u, c.get().size() );
+    c.insert(disNormal(0,1), 2000., true);
+    EXPECT_EQ( 3u, c.get().size() );
+    double normals = 0;
+    for (const auto& [d,ws] : c.get()) {
+        if (d->getID() == dFuncID::NORMAL_DISTR) normals += ws.first;
+    }
+    EXPECT_DOUBLE_EQ( 4000, normals );
+
+    // The index follows copies, moves and clear().
+    dCtr copy(c);
+    EXPECT_TRUE( copy.find(disUniform(0,2)) != copy.end() );
+    copy.insert(disUniform(0,2), 1., true);
+    EXPECT_EQ( 3u, copy.get().size() );
+    dCtr moved(std::move(copy));
+    EXPECT_TRUE( moved.find(disUniform(0,2)) != moved.end() );
+    copy = moved;
+    EXPECT_EQ( 3u, copy.get().size() );
+    EXPECT_EQ( copy.hash(), moved.hash() );
+    moved.clear();
+    EXPECT_TRUE( moved.find(disUniform(0,2)) == moved.end() );
+    moved.insert(disUniform(0,2), 1., true);
+    EXPECT_EQ( 1u, moved.get().size() );
+}
+
+TEST( dContainer_Tests, insert_many ) {
+    dCtr one;
+    std::vector<std::pair<disNormal,double>> normals;
+    std::vector<std::pair<std::unique_ptr<probDistr>,int>> mixed;
+    for (int i = 0; i < 500; ++i) {
+        normals.emplace_back(disNormal(i, 1+i%3), 1+i%5);
+        one.insert(disNormal(i, 1+i%3), 1+i%5);
+    }
+    mixed.emplace_back(std::make_unique<disUniform>(0,2), 3);
+    mixed.emplace_back(std::make_unique<disExponential>(1.5), 2);
+    one.insert(disUniform(0,2), 3);
+    one.insert(disExponential(1.5), 2);
+
+    dCtr many(normals);
+    many.insertMany(mixed);
+    EXPECT_EQ( one.hash(), many.hash() );
+    EXPECT_EQ( 502u, many.get().size() );
+    double sum = 0;
+    for (const auto& [d,ws] : many.get()) {sum += ws.second;}
+    EXPECT_NEAR( 1, sum, 1e-13 );
+
+    // Raw pointers, merged.
+    const disNormal n(0,1);
+    const disUniform u(0,1);
+    const std::pair<const probDistr*, double> ptrs[] = {{&n, 1}, {&u, 2}, {&n, 3}};
+    const dCtr merged(ptrs, true);
+    EXPECT_EQ( 2u, merged.get().size() );
+    EXPECT_DOUBLE_EQ( 4./6, merged.find(n)->second.second );
+    EXPECT_EQ( 3u, dCtr(ptrs).get().size() );
+}
+
+TEST( dContainer_Tests, merge_checks_type ) {
+    /* Same parameters, different types: never merged, never found for each other. */
+
+    const disNcChi a(3, 2);
+    const disNcChiSq b(3, 2);
+    const disRician c(3, 2);
+    EXPECT_NE( a.getID(), b.getID() );
+    EXPECT_NE( b.getID(), c.getID() );
+
+    dCtr m;
+    m.insert(a, 1, true);
+    EXPECT_NO_THROW( m.insert(b, 1, true) );
+    EXPECT_NO_THROW( m.insert(c, 1, true) );
+    m.insert(b, 2, true);
+    EXPECT_EQ( 3u, m.get().size() );
+    EXPECT_DOUBLE_EQ( 3, m.find(b)->second.first );
+    EXPECT_EQ( dFuncID::NC_CHI_DISTR, m.find(a)->first->getID() );
+
+    dCtr n;
+    n.insert(a, 1);
+    EXPECT_TRUE( n.find(b) == n.end() );
+}
+
+}
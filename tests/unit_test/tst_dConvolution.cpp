@@ -20,6 +20,8 @@
  *
  * (2) Sum of a list of Random Variabales
  *      R = A + B + C + D + ...
+ *
+ * (3) Monte Carlo fallback for pairs without a closed form
  */
 
 
@@ -28,6 +30,10 @@
 #include "density/disNormal.h"
 #include "density/disUniform.h"
 #include "density/disIrwinHall.h"
+#include "density/disGamma.h"
+#include "density/disRician.h"
+#include "density/disEmpirical.h"
+#include "parallelSampler.h"
 
 
 namespace statanaly {
@@ -180,4 +186,72 @@ TEST( dConvolution, list_Exponential ) {
     delete rn;
 };
 
-}
\ No newline at end of file
+
+
+TEST( dConvolution, monte_carlo_fallback ) {
+    /* Normal + Gamma has no closed form; by Monte Carlo when enabled. */
+
+    disNormal n{1,4};
+    disGamma g{3.,2.};
+    EXPECT_THROW( cnvl.go(n,g), std::runtime_error );
+
+    enableMonteCarloFallback({1<<18, 7, 2});
+    probDistr* rn = cnvl.go(n,g);
+    disEmpirical* re = dynamic_cast<disEmpirical*>(rn);
+    ASSERT_NE( re, nullptr );
+    EXPECT_EQ( re->size(), 1u<<18 );
+    EXPECT_NEAR( re->mean(), 7, 5*re->stdError() );
+    EXPECT_NEAR( re->variance(), 22, 0.03*22 );
+
+    // Registered pairs keep their closed form.
+    disNormal n2{2,1};
+    probDistr* rc = cnvl.go(n,n2);
+    EXPECT_NE( dynamic_cast<disNormal*>(rc), nullptr );
+
+    // R = X^2 + Y^2 of Rician and Uniform: E = a^2 + 2 sigma^2 + 1/3.
+    disRician ri{1.5,0.5};
+    disUniform u{0,1};
+    probDistr* rs = cnvlSq.go(ri,u);
+    EXPECT_NEAR( rs->mean(), 1.5*1.5 + 2*0.25 + 1./3, 5*dynamic_cast<disEmpirical*>(rs)->stdError() );
+
+    disableMonteCarloFallback();
+    EXPECT_THROW( cnvl.go(n,g), std::runtime_error );
+    EXPECT_THROW( cnvlSSqrt.go(ri,u), std::runtime_error );
+
+    delete rn;
+    delete rc;
+    delete rs;
+};
+
+
+TEST( dConvolution, monte_carlo_deterministic ) {
+    /* The samples depend on the seed, not on the number of threads. */
+
+    disNormal n{0,1};
+    disGamma g{1.,0.5};
+    std::unique_ptr<disEmpirical> a(convolveSSqrtMC(n, g, {50000, 11, 1}));
+    std::unique_ptr<disEmpirical> b(convolveSSqrtMC(n, g, {50000, 11, 3}));
+    std::unique_ptr<disEmpirical> c(convolveSSqrtMC(n, g, {50000, 12, 3}));
+
+    EXPECT_TRUE( a->isEqual_ulp(*b, 0) );
+    EXPECT_FALSE( a->isEqual_ulp(*c, 0) );
+    EXPECT_GE( a->samples().front(), 0 );
+
+    EXPECT_THROW( convolveMC(n, g, {0}), std::invalid_argument );
+};
+
+TEST( dConvolution, monte_carlo_caller_sampler ) {
+    /* A caller-owned sampler draws the same samples as the shared pools. */
+
+    disNormal n{0,1};
+    disGamma g{1.,0.5};
+    parallelSampler ps(2);
+    std::unique_ptr<disEmpirical> a(convolveMC(n, g, {50000, 11, 3}));
+    std::unique_ptr<disEmpirical> b(convolveMC(n, g, {50000, 11, 0, &ps}));
+    std::unique_ptr<disEmpirical> c(convolveMC(n, g, {50000, 11, 3}));
+
+    EXPECT_TRUE( a->isEqual_ulp(*b, 0) );
+    EXPECT_TRUE( a->isEqual_ulp(*c, 0) );
+};
+
+}
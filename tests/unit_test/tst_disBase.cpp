@@ -18,6 +18,19 @@
 #include "density/disUniform.h"
 #include "density/disNormal.h"
 #include "density/disChiSq.h"
+#include "density/disChi.h"
+#include "density/disCauchy.h"
+#include "density/disGamma.h"
+#include "density/disErlang.h"
+#include "density/disExponential.h"
+#include "density/disIrwinHall.h"
+#include "density/disRayleigh.h"
+#include "density/disRician.h"
+#include "density/disNcChi.h"
+#include "density/disNcChiSq.h"
+#include "density/disMixture.h"
+#include <random>
+#include <vector>
 
 namespace statanaly {
 
@@ -37,6 +50,13 @@ bool tst_isClone(const std::unique_ptr<T>& d1, const std::unique_ptr<F>& d2, dou
 
 
 
+/** Absolute tolerance; also accepts equal infinities and NaN against NaN. */
+bool tst_near(const double expected, const double actual, const double tol) {
+    if (std::isnan(expected)) return std::isnan(actual);
+    return expected == actual || std::abs(expected-actual) <= tol;
+}
+
+
 TEST(distribution_base_class, clone_via_cloneUnique) {
     // make a clone by calling a class method that calls std::make_unique (deep-copy).
 
@@ -113,4 +133,225 @@ TEST(distribution_base_class, clone_via_raw_ptr) {
 }
 
 
-}
\ No newline at end of file
+
+TEST(distribution_base_class, derived_constants_survive_copy_and_move) {
+    // Constants precomputed at construction must travel with the parameters.
+
+    const disGamma g(2., 3.5);
+    const double expected = g.pdf(1.7);
+
+    disGamma copied(g);
+    EXPECT_DOUBLE_EQ( expected, copied.pdf(1.7) );
+    disGamma moved(std::move(copied));
+    EXPECT_DOUBLE_EQ( expected, moved.pdf(1.7) );
+    std::unique_ptr<probDistr> cloned = g.cloneUnique();
+    EXPECT_DOUBLE_EQ( expected, cloned->pdf(1.7) );
+
+    const disNormal n(1., 4.);
+    disNormal n2(n);
+    EXPECT_DOUBLE_EQ( n.pdf(0.3), n2.pdf(0.3) );
+    EXPECT_DOUBLE_EQ( n.cdf(0.3), disNormal(std::move(n2)).cdf(0.3) );
+}
+
+
+TEST(distribution_base_class, batch_matches_scalar) {
+    // Batch evaluation through the base class must agree with the scalar path.
+    // Batches built on the vectorized kernels may differ by a few ulp.
+
+    std::vector<std::unique_ptr<probDistr>> ds;
+    ds.push_back(std::make_unique<disNormal>(1., 4.));
+    ds.push_back(std::make_unique<disStdUniform>());
+    ds.push_back(std::make_unique<disUniform>(0.5, 3.));
+    ds.push_back(std::make_unique<disCauchy>(1., 2.));
+    ds.push_back(std::make_unique<disGamma>(0.5, 3.));
+    ds.push_back(std::make_unique<disErlang>(3, 2.));
+    ds.push_back(std::make_unique<disExponential>(1.5));
+    ds.push_back(std::make_unique<disChi>(3));
+    ds.push_back(std::make_unique<disChiSq>(5));
+    ds.push_back(std::make_unique<disIrwinHall>(4));
+    ds.push_back(std::make_unique<disRayleigh>(2.));
+    ds.push_back(std::make_unique<disRician>(2., 1.5));
+    ds.push_back(std::make_unique<disNcChi>(3, 1.5));
+    ds.push_back(std::make_unique<disNcChiSq>(3, 2.));
+
+    std::vector<double> x;
+    for (int i=1; i<40; i++) {x.push_back(0.1*i);}
+    std::vector<double> r(x.size());
+
+    for (const auto& d : ds) {
+        d->pdf(x, r);
+        for (std::size_t i=0; i<x.size(); i++) {EXPECT_TRUE(tst_near(d->pdf(x[i]), r[i], 1e-13*std::abs(d->pdf(x[i]))));}
+
+        d->cdf(x, r);
+        for (std::size_t i=0; i<x.size(); i++) {EXPECT_TRUE(tst_near(d->cdf(x[i]), r[i], 1e-13*std::abs(d->cdf(x[i]))));}
+
+        d->logpdf(x, r);
+        for (std::size_t i=0; i<x.size(); i++) {EXPECT_TRUE(tst_near(std::log(d->pdf(x[i])), r[i], 1e-12));}
+    }
+}
+
+TEST(distribution_base_class, log_and_survival_match_definitions) {
+    // Native logpdf/logcdf/sf/logsf must agree with their definitions where
+    // those are well conditioned, in both scalar and batch form.
+
+    std::vector<std::unique_ptr<probDistr>> ds;
+    ds.push_back(std::make_unique<disNormal>(1., 4.));
+    ds.push_back(std::make_unique<disStdUniform>());
+    ds.push_back(std::make_unique<disUniform>(0.5, 3.));
+    ds.push_back(std::make_unique<disCauchy>(1., 2.));
+    ds.push_back(std::make_unique<disGamma>(0.5, 3.));
+    ds.push_back(std::make_unique<disErlang>(3, 2.));
+    ds.push_back(std::make_unique<disExponential>(1.5));
+    ds.push_back(std::make_unique<disChi>(3));
+    ds.push_back(std::make_unique<disChiSq>(5));
+    ds.push_back(std::make_unique<disIrwinHall>(4));
+    ds.push_back(std::make_unique<disRayleigh>(2.));
+    ds.push_back(std::make_unique<disRician>(2., 1.5));
+    ds.push_back(std::make_unique<disNcChi>(3, 1.5));
+    ds.push_back(std::make_unique<disNcChiSq>(3, 2.));
+
+    std::vector<double> x;
+    for (int i=1; i<36; i++) {x.push_back(0.1*i);}
+    std::vector<double> r(x.size());
+
+    for (const auto& d : ds) {
+        for (const double v : x) {
+            EXPECT_TRUE(tst_near(std::log(d->pdf(v)), d->logpdf(v), 1e-12)) << *d << "  x = " << v;
+            EXPECT_TRUE(tst_near(std::log(d->cdf(v)), d->logcdf(v), 1e-12)) << *d << "  x = " << v;
+            EXPECT_TRUE(tst_near(1-d->cdf(v), d->sf(v), 1e-12)) << *d << "  x = " << v;
+            EXPECT_TRUE(tst_near(std::log(1-d->cdf(v)), d->logsf(v), 1e-9)) << *d << "  x = " << v;
+        }
+
+        d->logpdf(x, r);
+        for (std::size_t i=0; i<x.size(); i++) {EXPECT_TRUE(tst_near(d->logpdf(x[i]), r[i], 1e-13));}
+        d->logcdf(x, r);
+        for (std::size_t i=0; i<x.size(); i++) {EXPECT_TRUE(tst_near(d->logcdf(x[i]), r[i], 1e-13));}
+        d->sf(x, r);
+        for (std::size_t i=0; i<x.size(); i++) {EXPECT_TRUE(tst_near(d->sf(x[i]), r[i], 1e-13*d->sf(x[i])));}
+        d->logsf(x, r);
+        for (std::size_t i=0; i<x.size(); i++) {EXPECT_TRUE(tst_near(d->logsf(x[i]), r[i], 1e-13));}
+    }
+}
+
+TEST(distribution_base_class, quantile_inverts_cdf) {
+    std::vector<std::unique_ptr<probDistr>> ds;
+    ds.push_back(std::make_unique<disNormal>(1., 4.));
+    ds.push_back(std::make_unique<disStdUniform>());
+    ds.push_back(std::make_unique<disUniform>(0.5, 3.));
+    ds.push_back(std::make_unique<disCauchy>(1., 2.));
+    ds.push_back(std::make_unique<disGamma>(0.5, 3.));
+    ds.push_back(std::make_unique<disGamma>(2., 0.3));
+    ds.push_back(std::make_unique<disErlang>(3, 2.));
+    ds.push_back(std::make_unique<disExponential>(1.5));
+    ds.push_back(std::make_unique<disChi>(3));
+    ds.push_back(std::make_unique<disChiSq>(5));
+    ds.push_back(std::make_unique<disIrwinHall>(4));
+    ds.push_back(std::make_unique<disIrwinHall>(300));
+    ds.push_back(std::make_unique<disRayleigh>(2.));
+    ds.push_back(std::make_unique<disRician>(2., 1.5));
+    ds.push_back(std::make_unique<disNcChi>(3, 1.5));
+    ds.push_back(std::make_unique<disNcChiSq>(3, 2.));
+
+    auto mix = std::make_unique<disMixture>();
+    mix->insert(disNormal(0., 1.), 0.3);
+    mix->insert(disNormal(4., 2.), 0.7);
+    ds.push_back(std::move(mix));
+
+    const std::vector<double> p = {1e-6, 0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99, 0.999999};
+    std::vector<double> r(p.size());
+
+    for (const auto& d : ds) {
+        d->quantile(p, r);
+        for (std::size_t i=0; i<p.size(); i++) {
+            EXPECT_DOUBLE_EQ(d->quantile(p[i]), r[i]) << *d;
+            EXPECT_NEAR(p[i], d->cdf(r[i]), 1e-12) << *d << "  p = " << p[i];
+        }
+        EXPECT_THROW(d->quantile(1.5), std::invalid_argument);
+        EXPECT_THROW(d->quantile(-0.1), std::invalid_argument);
+    }
+}
+
+TEST(distribution_base_class, batch_outside_support) {
+    // Log-space batches fall back to the scalar path where log(x) is undefined.
+    const std::vector<double> x = {-1., 0., 1e-300, 1.};
+    std::vector<double> r(x.size());
+
+    disGamma g(0.5, 3.);
+    g.pdf(x, r);
+    for (std::size_t i=0; i<x.size(); i++) {EXPECT_TRUE(tst_near(g.pdf(x[i]), r[i], 1e-13*std::abs(g.pdf(x[i]))));}
+
+    disChiSq c(4);
+    c.pdf(x, r);
+    for (std::size_t i=0; i<x.size(); i++) {EXPECT_TRUE(tst_near(c.pdf(x[i]), r[i], 1e-13*std::abs(c.pdf(x[i]))));}
+}
+
+TEST(distribution_base_class, batch_rejects_short_output) {
+    disNormal d(0, 1);
+    std::vector<double> x(4, 0.), r(3);
+    EXPECT_THROW(d.pdf(x, r), std::invalid_argument);
+}
+
+TEST(distribution_base_class, sample_matches_cdf) {
+    // Kolmogorov-Smirnov distance of scalar and batch samples from cdf().
+    // 1.95/sqrt(n) is the 0.1% critical value; the seed is fixed.
+
+    std::vector<std::unique_ptr<probDistr>> ds;
+    ds.push_back(std::make_unique<disNormal>(1., 4.));
+    ds.push_back(std::make_unique<disStdUniform>());
+    ds.push_back(std::make_unique<disUniform>(0.5, 3.));
+    ds.push_back(std::make_unique<disCauchy>(1., 2.));
+    ds.push_back(std::make_unique<disGamma>(0.5, 3.));
+    ds.push_back(std::make_unique<disGamma>(2., 0.3));
+    ds.push_back(std::make_unique<disErlang>(3, 2.));
+    ds.push_back(std::make_unique<disErlang>(20, 0.5));
+    ds.push_back(std::make_unique<disExponential>(1.5));
+    ds.push_back(std::make_unique<disChi>(3));
+    ds.push_back(std::make_unique<disChiSq>(1));
+    ds.push_back(std::make_unique<disChiSq>(4));
+    ds.push_back(std::make_unique<disChiSq>(5));
+    ds.push_back(std::make_unique<disChiSq>(30));
+    ds.push_back(std::make_unique<disIrwinHall>(4));
+    ds.push_back(std::make_unique<disRayleigh>(2.));
+    ds.push_back(std::make_unique<disRician>(2., 1.5));
+    ds.push_back(std::make_unique<disNcChi>(3, 1.5));
+    ds.push_back(std::make_unique<disNcChiSq>(3, 2.));
+
+    auto mix = std::make_unique<disMixture>();
+    mix->insert(disNormal(0., 1.), 0.3);
+    mix->insert(disNormal(4., 2.), 0.7);
+    ds.push_back(std::move(mix));
+
+    auto ksDistance = [](const probDistr& d, std::vector<double> x){
+        std::sort(x.begin(), x.end());
+        const double n = x.size();
+        double D = 0;
+        for (std::size_t i=0; i<x.size(); i++) {
+            const double F = d.cdf(x[i]);
+            D = std::max({D, F - i/n, (i+1)/n - F});
+        }
+        return D;
+    };
+
+    constexpr std::size_t n = 10000;
+    std::mt19937_64 eng(20221017);
+    for (const auto& d : ds) {
+        std::vector<double> x(n);
+        for (auto& v : x) {v = d->sample(eng);}
+        EXPECT_LT(ksDistance(*d, x), 1.95/std::sqrt(n)) << *d;
+
+        d->sample(eng, x);
+        EXPECT_LT(ksDistance(*d, x), 1.95/std::sqrt(n)) << *d;
+    }
+}
+
+TEST(distribution_base_class, sample_is_reproducible) {
+    disGamma g(2., 0.3);
+    std::vector<double> a(1000), b(1000);
+    std::mt19937 e1(7), e2(7);
+    g.sample(e1, a);
+    g.sample(e2, b);
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(g.sample(e1), g.sample(e2));
+}
+
+}
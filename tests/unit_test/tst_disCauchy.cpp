@@ -31,6 +31,21 @@ TEST( Cauchy_Distribution, cdf ) {
     EXPECT_DOUBLE_EQ( 0.89758361765043326, d1.cdf(10) );
 }
 
+TEST( Cauchy_Distribution, cdf_lower_tail ) {
+    disCauchy d1(4,2);
+
+    for (const double p : {1e-6, 1e-12, 0.3}) {
+        const double x = d1.quantile(p);
+        EXPECT_NEAR( p, d1.cdf(x), 1e-14*p );
+        EXPECT_NEAR( std::exp(d1.logcdf(x)), d1.cdf(x), 1e-14*p );
+    }
+
+    const std::vector<double> x{-1e9, -3., 4., 4.5, 1e9};
+    std::vector<double> r(x.size());
+    d1.cdf(x, r);
+    for (std::size_t i=0; i<x.size(); ++i) {EXPECT_NEAR( d1.cdf(x[i]), r[i], 1e-15*d1.cdf(x[i]) );}
+}
+
 
 
 }
\ No newline at end of file
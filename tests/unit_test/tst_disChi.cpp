@@ -32,5 +32,11 @@ TEST( Chi_Distribution_Tests, cdf ) {
     EXPECT_DOUBLE_EQ(expe, myChi.cdf(6));
 };
 
+TEST( Chi_Distribution_Tests, cdf_negative_support ) {
+    auto myChi = disChi(3);
+    EXPECT_EQ(0., myChi.cdf(-2));
+    EXPECT_EQ(1., myChi.sf(-2));
+};
+
 
 }
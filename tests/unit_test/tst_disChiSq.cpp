@@ -42,4 +42,11 @@ TEST( ChiSquare_Distribution_Tests, hash ) {
 };
 
 
+TEST( ChiSquare_Distribution_Tests, quantile ) {
+    disChiSq d(5);
+    EXPECT_DOUBLE_EQ( 11.070497693516351, d.quantile(0.95) );
+    EXPECT_DOUBLE_EQ( 0.5542980767282772, d.quantile(0.01) );
+    EXPECT_EQ( 0, d.quantile(0) );
+}
+
 }
\ No newline at end of file
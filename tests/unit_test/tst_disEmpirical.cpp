@@ -0,0 +1,159 @@
+/*
+   Copyright 2022, Ansel Blumers
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "gtest/gtest.h"
+#include "density/disEmpirical.h"
+#include "density/disNormal.h"
+#include "rand_num_gen.h"
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+#include <vector>
+
+
+namespace statanaly {
+
+TEST( Empirical_Distribution, order_statistics ) {
+    const disEmpirical d({4., 1., 3., 2., 5.});
+
+    EXPECT_EQ( d.size(), 5u );
+    EXPECT_EQ( d.samples().front(), 1 );
+    EXPECT_EQ( d.samples().back(), 5 );
+
+    EXPECT_EQ( d.cdf(0.5), 0 );
+    EXPECT_EQ( d.cdf(1), 0.2 );
+    EXPECT_EQ( d.cdf(3.5), 0.6 );
+    EXPECT_EQ( d.cdf(5), 1 );
+    EXPECT_DOUBLE_EQ( d.sf(3.5), 0.4 );
+
+    EXPECT_EQ( d.quantile(0), 1 );
+    EXPECT_EQ( d.quantile(1), 5 );
+    EXPECT_DOUBLE_EQ( d.quantile(0.5), 3 );
+    EXPECT_DOUBLE_EQ( d.quantile(0.3), 2.2 );
+
+    EXPECT_DOUBLE_EQ( d.mean(), 3 );
+    EXPECT_DOUBLE_EQ( d.variance(), 2 );
+    EXPECT_NEAR( d.skewness(), 0, 1e-15 );
+    EXPECT_DOUBLE_EQ( d.stdError(), std::sqrt(2./5) );
+}
+
+TEST( Empirical_Distribution, approximates_the_source ) {
+    const disNormal n(2,9);
+    rng_philox eng(5);
+    std::vector<double> x(1<<16);
+    n.sample(eng, x);
+    const disEmpirical d(x);
+
+    EXPECT_NEAR( d.mean(), 2, 5*d.stdError() );
+    EXPECT_NEAR( d.stddev(), 3, 0.05 );
+    for (double v = -6; v <= 10; v += 0.5) {
+        EXPECT_NEAR( d.cdf(v), n.cdf(v), 5*d.stdErrorCdf(v) + 1e-4 ) << "x = " << v;
+        EXPECT_NEAR( d.pdf(v), n.pdf(v), 0.1*n.pdf(2) ) << "x = " << v;
+    }
+    EXPECT_NEAR( d.quantile(0.9), n.quantile(0.9), 0.05 );
+
+    std::vector<double> s(1000);
+    d.sample(eng, s);
+    for (const double v : s) {
+        EXPECT_GE( v, d.samples().front() );
+        EXPECT_LE( v, d.samples().back() );
+    }
+}
+
+TEST( Empirical_Distribution, copy_and_hash ) {
+    const disEmpirical d({0.5, -1., 2.});
+    const disEmpirical c({2., 0.5, -1.});
+    const disEmpirical e({2., 0.5, -1.5});
+
+    EXPECT_EQ( d.hash(), c.hash() );
+    EXPECT_NE( d.hash(), e.hash() );
+    EXPECT_TRUE( d.isEqual_ulp(c, 0) );
+    EXPECT_FALSE( d.isEqual_tol(e, 0.1) );
+    EXPECT_TRUE( d.isEqual_tol(e, 0.6) );
+
+    std::unique_ptr<probDistr> p = d.cloneUnique();
+    EXPECT_EQ( p->getID(), dFuncID::EMPIRICAL_DISTR );
+    EXPECT_EQ( p->cdf(0.7), d.cdf(0.7) );
+    EXPECT_EQ( p->hash(), d.hash() );
+
+    // Copies share the samples.
+    const disEmpirical* q = static_cast<const disEmpirical*>(p.get());
+    EXPECT_EQ( q->samples().data(), d.samples().data() );
+}
+
+TEST( Empirical_Distribution, smoothed_pdf ) {
+    /* Continuous in x, and integrates to one. */
+
+    const disNormal n(0,1);
+    rng_philox eng(2);
+    std::vector<double> x(5000);
+    n.sample(eng, x);
+    const disEmpirical d(x);
+
+    double area = 0, last = d.pdf(-8);
+    const double dx = 1e-3;
+    for (double v = -8; v < 8; v += dx) {
+        const double p = d.pdf(v + dx);
+        EXPECT_LT( std::abs(p - last), 1e-2 ) << "x = " << v;
+        area += 0.5*(p + last)*dx;
+        last = p;
+    }
+    EXPECT_NEAR( area, 1, 1e-3 );
+}
+
+TEST( Empirical_Distribution, memory_mapped_file ) {
+    const auto file = std::filesystem::temp_directory_path()
+        / ("statanaly_empirical_" + std::to_string(::getpid()) + ".bin");
+
+    const disEmpirical d({2.5, -1., 4., 0.25, 3.});
+    d.save(file);
+    {
+        const disEmpirical m(file);
+        EXPECT_TRUE( m.isEqual_ulp(d, 0) );
+        EXPECT_EQ( m.mean(), d.mean() );
+        EXPECT_EQ( m.variance(), d.variance() );
+        EXPECT_EQ( m.quantile(0.6), d.quantile(0.6) );
+        EXPECT_EQ( m.pdf(1.5), d.pdf(1.5) );
+    }
+
+    // A raw, unsorted file: refused unless it may be sorted in place.
+    const double raw[4] = {3., 1., 2., -5.};
+    std::ofstream(file, std::ios::binary).write(reinterpret_cast<const char*>(raw), sizeof raw);
+    EXPECT_THROW( disEmpirical{file}, std::invalid_argument );
+    {
+        const disEmpirical m(file, true);
+        EXPECT_EQ( m.samples().front(), -5 );
+        EXPECT_EQ( m.cdf(2.5), 0.75 );
+    }
+    const disEmpirical sorted(file);
+    EXPECT_EQ( sorted.samples().back(), 3 );
+
+    std::ofstream(file, std::ios::binary | std::ios::trunc).write(reinterpret_cast<const char*>(raw), 12);
+    EXPECT_THROW( disEmpirical{file}, std::invalid_argument );
+    std::filesystem::remove(file);
+    EXPECT_THROW( disEmpirical{file}, std::runtime_error );
+}
+
+TEST( Empirical_Distribution, invalid_samples ) {
+    EXPECT_THROW( disEmpirical(std::vector<double>{}), std::invalid_argument );
+    EXPECT_THROW( disEmpirical({1., NAN}), std::invalid_argument );
+
+    const disEmpirical d({3., 3.});
+    EXPECT_EQ( d.pdf(3), INFINITY );
+    EXPECT_EQ( d.pdf(2.9), 0 );
+    EXPECT_EQ( d.quantile(0.4), 3 );
+}
+
+}
@@ -15,6 +15,7 @@
 */
 #include "gtest/gtest.h"
 #include "density/disErlang.h"
+#include <vector>
 
 
 namespace statanaly {
@@ -35,4 +36,36 @@ TEST( Erlang_Distribution, cdf ) {
     EXPECT_DOUBLE_EQ( expected, d1.cdf(x) );
 }
 
+TEST( Erlang_Distribution, huge_shape ) {
+    // Reference: mpmath in 50-digit arithmetic.
+
+    disErlang d50(50, 1.5);
+    EXPECT_NEAR( 0.07180387467931434787, d50.pdf(30), 1e-15 );
+    EXPECT_NEAR( 0.24680203440017027271, d50.cdf(30), 1e-15 );
+
+    disErlang d(1000000, 2);
+    EXPECT_NEAR( 0.00079788329748730911257, d.pdf(500000.5), 1e-14*0.000798 );
+    EXPECT_NEAR( 2.6304617959176097427e-7,  d.pdf(498000),   1e-13*2.63e-7 );
+    EXPECT_NEAR( -15.150936232381007792,    d.logpdf(498000), 1e-13 );
+    EXPECT_NEAR( 0.50053192274206756324,    d.cdf(500000.5), 1e-14 );
+    EXPECT_NEAR( 0.000031007118211082967394, d.cdf(498000),  1e-13*3.1e-5 );
+    EXPECT_NEAR( 0.25, d.cdf(d.quantile(0.25)), 1e-12 );
+
+    EXPECT_EQ( 0., d.pdf(0) );
+    EXPECT_EQ( 0., d.pdf(-1) );
+}
+
+TEST( Erlang_Distribution, batch_matches_scalar ) {
+    disErlang d(1000000, 2);
+    std::vector<double> x, r(300);
+    for (int i=0; i<300; ++i) {x.push_back(495000 + 33.3*i);}
+
+    d.pdf(x, r);
+    for (int i=0; i<300; ++i) {EXPECT_NEAR( d.pdf(x[i]), r[i], 1e-14*d.pdf(x[i]) );}
+    d.logpdf(x, r);
+    for (int i=0; i<300; ++i) {EXPECT_EQ( d.logpdf(x[i]), r[i] );}
+    d.cdf(x, r);
+    for (int i=0; i<300; ++i) {EXPECT_EQ( d.cdf(x[i]), r[i] );}
+}
+
 }
\ No newline at end of file
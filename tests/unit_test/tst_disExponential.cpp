@@ -32,4 +32,32 @@ TEST( Exponential_Distribution, cdf ) {
 }
 
 
+TEST( Exponential_Distribution, log_and_survival ) {
+    disExponential d1(2.);
+
+    EXPECT_DOUBLE_EQ(std::log(2.) - 2., d1.logpdf(1.));
+    EXPECT_DOUBLE_EQ(-2000., d1.logsf(1000.));
+    EXPECT_DOUBLE_EQ(std::exp(-2.), d1.sf(1.));
+    // log(1-exp(-2e-10)), where 1-cdf cancellation would lose every digit.
+    EXPECT_DOUBLE_EQ(-2.233270374948051153e+01, d1.logcdf(1e-10));
+    EXPECT_DOUBLE_EQ(2e-10, d1.cdf(1e-10) / (1 - 1e-10));
+}
+
+TEST( Exponential_Distribution, below_support ) {
+    disExponential d1(2.);
+
+    EXPECT_EQ(0., d1.cdf(-1.));
+    EXPECT_EQ(1., d1.sf(-1.));
+    EXPECT_EQ(0., d1.logsf(-1.));
+    EXPECT_EQ(-INFINITY, d1.logcdf(-1.));
+
+    const std::vector<double> x{-1., 1e-10, 0.2, 3.};
+    std::vector<double> r(x.size());
+    d1.cdf(x, r);
+    for (std::size_t i=0; i<x.size(); ++i) {EXPECT_EQ(d1.cdf(x[i]), r[i]);}
+    d1.sf(x, r);
+    EXPECT_EQ(1., r[0]);
+}
+
+
 }
\ No newline at end of file
@@ -34,4 +34,11 @@ TEST( Gamma_Distribution, cdf ) {
 }
 
 
+TEST( Gamma_Distribution, huge_shape ) {
+    // Reference: mpmath in 50-digit arithmetic.
+    disGamma d(0.25, 2500000.5);
+    EXPECT_NEAR( 0.001008922048428661158, d.pdf(625010), 1e-14*0.00101 );
+    EXPECT_EQ( 0., d.pdf(0) );
+}
+
 }
\ No newline at end of file
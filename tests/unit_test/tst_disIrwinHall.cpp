@@ -15,6 +15,7 @@
 */
 #include "gtest/gtest.h"
 #include "density/disIrwinHall.h"
+#include <vector>
 
 
 namespace statanaly {
@@ -72,35 +73,40 @@ TEST( Irwin_Hall_Distribution, pdf ) {
 }
 
 TEST( Irwin_Hall_Distribution, cdf ) {
-    /* cdf is just pdf divided by n */
     disIrwinHall d1(1);
     for (double x=-0.01; x<1.1; x+=0.01) {
-        if (0<=x && x<1)
-            EXPECT_DOUBLE_EQ( 1, d1.cdf(x) );
-        else 
+        if (x<0)
             EXPECT_DOUBLE_EQ( 0, d1.cdf(x) );
+        else if (x<=1)
+            EXPECT_DOUBLE_EQ( x, d1.cdf(x) );
+        else 
+            EXPECT_DOUBLE_EQ( 1, d1.cdf(x) );
     }
 
     disIrwinHall d2(2);
     for (double x=-0.01; x<2.1; x+=0.01) {
-        if (0<=x && x<=1)
-            EXPECT_DOUBLE_EQ( x/2, d2.cdf(x) );
-        else if (1<x && x<=2)
-            EXPECT_DOUBLE_EQ( (2-x)/2, d2.cdf(x) );
-        else 
+        if (x<0)
             EXPECT_DOUBLE_EQ( 0, d2.cdf(x) );
+        else if (x<=1)
+            EXPECT_DOUBLE_EQ( x*x/2, d2.cdf(x) );
+        else if (x<=2)
+            EXPECT_DOUBLE_EQ( 1-(2-x)*(2-x)/2, d2.cdf(x) );
+        else 
+            EXPECT_DOUBLE_EQ( 1, d2.cdf(x) );
     }
     
     disIrwinHall d3(3);
     for (double x=-0.01; x<3.1; x+=0.01) {
-        if (0<=x && x<=1)
-            EXPECT_FLOAT_EQ( .5*x*x/3, d3.cdf(x) );
-        else if (1<x && x<=2)
-            EXPECT_FLOAT_EQ( .5*(-2*x*x+6*x-3)/3, d3.cdf(x) );
-        else if (2<x && x<=3)
-            EXPECT_NEAR( .5*(x-3)*(x-3)/3, d3.cdf(x), 1e-15 );
+        if (x<0)
+            EXPECT_DOUBLE_EQ( 0, d3.cdf(x) );
+        else if (x<=1)
+            EXPECT_NEAR( x*x*x/6, d3.cdf(x), 1e-15 );
+        else if (x<=2)
+            EXPECT_NEAR( (x*x*x-3*(x-1)*(x-1)*(x-1))/6, d3.cdf(x), 1e-15 );
+        else if (x<=3)
+            EXPECT_NEAR( 1-(3-x)*(3-x)*(3-x)/6, d3.cdf(x), 1e-15 );
         else 
-            EXPECT_NEAR( 0, d3.cdf(x), 1e-15 );
+            EXPECT_DOUBLE_EQ( 1, d3.cdf(x) );
     }
     
     disIrwinHall d4(4);
@@ -115,6 +121,97 @@ TEST( Irwin_Hall_Distribution, cdf ) {
             EXPECT_NEAR( 1./6*(4-x)*(4-x)*(4-x), d4.pdf(x), 1e-14 );
         else 
             EXPECT_NEAR( 0, d4.pdf(x), 1e-14 );
+
+        if (x<0)
+            EXPECT_DOUBLE_EQ( 0, d4.cdf(x) );
+        else if (x<=1)
+            EXPECT_NEAR( x*x*x*x/24, d4.cdf(x), 1e-15 );
+        else if (x<=2)
+            EXPECT_NEAR( (x*x*x*x-4*(x-1)*(x-1)*(x-1)*(x-1))/24, d4.cdf(x), 1e-15 );
+        else if (x<=4)
+            EXPECT_NEAR( 1-d4.cdf(4-x), d4.cdf(x), 1e-15 );
+        else 
+            EXPECT_DOUBLE_EQ( 1, d4.cdf(x) );
+    }
+}
+
+TEST( Irwin_Hall_Distribution, sf_is_reflected_cdf ) {
+    disIrwinHall d(7);
+    for (double x=-0.5; x<7.5; x+=0.125) {
+        EXPECT_DOUBLE_EQ( d.cdf(7-x), d.sf(x) );
+    }
+    // The upper tail keeps its relative accuracy.
+    EXPECT_DOUBLE_EQ( std::pow(0.125, 7)/5040, d.sf(6.875) );
+}
+
+TEST( Irwin_Hall_Distribution, large_n ) {
+    // Reference: the alternating sum in (n+60)-digit arithmetic.
+
+    disIrwinHall d30(30);
+    EXPECT_NEAR( 0.059312273631049791702, d30.pdf(12.3), 1e-15 );
+    EXPECT_NEAR( 0.04387576299118558176,  d30.cdf(12.3), 1e-15 );
+
+    disIrwinHall d200(200);
+    EXPECT_NEAR( 4.1099082484925865917e-37, d200.pdf(150), 1e-13*4.11e-37 );
+    EXPECT_NEAR( 1.1388621816315662335e-37, d200.sf(150),  1e-13*1.14e-37 );
+
+    disIrwinHall d1000(1000);
+    EXPECT_NEAR( 0.0044641125077943930703, d1000.pdf(480.5), 1e-16 );
+    EXPECT_NEAR( 0.016328093093755433377,  d1000.cdf(480.5), 1e-15 );
+    EXPECT_NEAR( 3.7622352797116531635e-62, d1000.pdf(350.25), 1e-13*3.76e-62 );
+    EXPECT_NEAR( 1.9708374357143069434e-62, d1000.cdf(350.25), 1e-13*1.97e-62 );
+    EXPECT_NEAR( 3.7622352797116531635e-62, d1000.pdf(649.75), 1e-13*3.76e-62 );
+
+    disIrwinHall d5000(5000);
+    EXPECT_NEAR( 0.012383809100312472165, d5000.pdf(2480.5), 1e-16 );
+    EXPECT_NEAR( 0.16971779201797939826,  d5000.cdf(2480.5), 1e-15 );
+    EXPECT_NEAR( 0.83028220798202060174,  d5000.sf(2480.5),  1e-15 );
+}
+
+TEST( Irwin_Hall_Distribution, far_tail ) {
+    // Past splineBudget the saddle point takes over. Reference: the
+    // de Boor-Cox recursion, run without the budget.
+    disIrwinHall d3000(3000);
+    EXPECT_NEAR( 1.7899470396639319e-51, d3000.pdf(1263), 1e-11*1.79e-51 );
+    EXPECT_NEAR( 1.8516826830652881e-51, d3000.cdf(1263), 1e-11*1.85e-51 );
+    EXPECT_NEAR( 1.8516826830652881e-51, d3000.sf(1737),  1e-11*1.85e-51 );
+
+    // z = -30 at n = 1e5: the cdf is consistent with the density.
+    disIrwinHall d(100000);
+    const double x = 50000 - 30*std::sqrt(100000/12.), h = 1e-3;
+    const double p = d.pdf(x);
+    EXPECT_GT( p, 0 );
+    EXPECT_NEAR( p, (d.cdf(x+h) - d.cdf(x-h))/(2*h), 1e-7*p );
+}
+
+TEST( Irwin_Hall_Distribution, quantile_ends_and_upper_tail ) {
+    disIrwinHall d(5);
+    EXPECT_EQ( 0., d.quantile(0) );
+    EXPECT_EQ( 5., d.quantile(1) );
+    EXPECT_DOUBLE_EQ( 2.5, d.quantile(0.5) );
+
+    // Upper quantiles mirror the lower ones; sf keeps their accuracy.
+    for (const double q : {1-1e-12, 1-1e-6, 0.99, 0.7}) {
+        const double p = 1-q;   // exact
+        EXPECT_DOUBLE_EQ( 5 - d.quantile(p), d.quantile(q) );
+        EXPECT_NEAR( p, d.sf(d.quantile(q)), 1e-12*p );
+    }
+    // x^5/120 = p near 0.
+    EXPECT_NEAR( std::pow(120e-12, 0.2), d.quantile(1e-12), 1e-15 );
+}
+
+TEST( Irwin_Hall_Distribution, batch_matches_scalar ) {
+    for (const unsigned n : {5u, 150u}) {
+        disIrwinHall d(n);
+        std::vector<double> x, r(400);
+        for (int i=0; i<400; ++i) {x.push_back((i-20)*(n+2.)/360);}
+
+        d.pdf(x, r);
+        for (int i=0; i<400; ++i) {EXPECT_NEAR( d.pdf(x[i]), r[i], 1e-14*d.pdf(x[i]) );}
+        d.cdf(x, r);
+        for (int i=0; i<400; ++i) {EXPECT_NEAR( d.cdf(x[i]), r[i], 1e-14*d.cdf(x[i]) );}
+        d.sf(x, r);
+        for (int i=0; i<400; ++i) {EXPECT_NEAR( d.sf(x[i]), r[i], 1e-14*d.sf(x[i]) );}
     }
 }
 
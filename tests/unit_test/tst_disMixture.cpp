@@ -17,6 +17,8 @@
 #include "density/disMixture.h"
 #include "density/disNormal.h"
 #include "density/disUniform.h"
+#include "density/disGamma.h"
+#include <random>
 
 
 namespace statanaly {
@@ -92,6 +94,32 @@ TEST( Mixture_Distribution_Tests, find ) {
     delete dRaw;
 }
 
+TEST( Mixture_Distribution_Tests, insert_merge ) {
+    disMixture merged, plain;
+    for (int i = 0; i < 3; ++i) {merged.insert(disNormal(2,1), 1, true);}
+    merged.insert(disUniform(0,1), 1, true);
+    plain.insert(disNormal(2,1), 3);
+    plain.insert(disUniform(0,1), 1);
+
+    EXPECT_EQ( 2u, merged.get().size() );
+    EXPECT_TRUE( merged.hash() == plain.hash() );
+    EXPECT_DOUBLE_EQ( merged.pdf(1.5), plain.pdf(1.5) );
+}
+
+TEST( Mixture_Distribution_Tests, bulk_construction ) {
+    std::vector<std::pair<disNormal,double>> comps;
+    disMixture one;
+    for (int i = 0; i < 200; ++i) {
+        comps.emplace_back(disNormal(i%50, 1), 1);
+        one.insert(disNormal(i%50, 1), 1, true);
+    }
+    const disMixture frozen(comps, true);
+    EXPECT_EQ( 50u, frozen.get().size() );
+    EXPECT_TRUE( frozen.hash() == one.hash() );
+    EXPECT_DOUBLE_EQ( frozen.pdf(10.3), one.pdf(10.3) );
+    EXPECT_DOUBLE_EQ( frozen.mean(), one.mean() );
+}
+
 TEST( Mixture_Distribution_Tests, hash ) {
     // Test whether two Mixture distributions are different.
 
@@ -274,4 +302,149 @@ TEST( Mixture_Distribution_Tests, skewness_M2 ) {
 }
 
 
-}
\ No newline at end of file
+
+TEST( Mixture_Distribution_Tests, batch ) {
+    std::unique_ptr<disMixture> myMixture = constructSmartMixture();
+
+    std::vector<double> x{-1., 0., 0.25, 0.5, 1., 2., 3.5};
+    std::vector<double> r(x.size());
+
+    myMixture->pdf(x, r);
+    for (std::size_t i=0; i<x.size(); i++) {EXPECT_NEAR(myMixture->pdf(x[i]), r[i], 1e-15);}
+
+    myMixture->cdf(x, r);
+    for (std::size_t i=0; i<x.size(); i++) {EXPECT_NEAR(myMixture->cdf(x[i]), r[i], 1e-15);}
+}
+
+TEST( Mixture_Distribution_Tests, type_groups ) {
+    /* Grouped evaluation equals the weighted sum over the components. */
+
+    disMixture m;
+    std::mt19937_64 eng(8);
+    std::uniform_real_distribution<double> u(0.1, 3.);
+    for (int i=0; i<300; i++) {m.insert(disNormal(u(eng)-1.5, u(eng)), u(eng));}
+    for (int i=0; i<20; i++) {m.insert(disUniform(-u(eng), u(eng)), u(eng));}
+    m.insert(disStdUniform(), 0.5);
+    m.insert(disGamma(u(eng), u(eng)), 2.);
+
+    std::vector<double> x;
+    for (double v = -6; v <= 6; v += 0.037) {x.push_back(v);}
+    std::vector<double> r(x.size());
+    using fn = double (probDistr::*)(const double) const;
+    for (const fn f : {fn(&probDistr::pdf), fn(&probDistr::cdf), fn(&probDistr::sf)}) {
+        std::vector<double> e(x.size(), 0.);
+        for (const auto& [d,ws] : m.get()) {
+            for (std::size_t i=0; i<x.size(); i++) {e[i] += ws.second * (d->*f)(x[i]);}
+        }
+        for (std::size_t i=0; i<x.size(); i++) {EXPECT_NEAR( (m.*f)(x[i]), e[i], 1e-14*(1+e[i]) );}
+    }
+
+    m.pdf(x, r);
+    for (std::size_t i=0; i<x.size(); i++) {EXPECT_NEAR( m.pdf(x[i]), r[i], 1e-14 );}
+    m.sf(x, r);
+    for (std::size_t i=0; i<x.size(); i++) {EXPECT_NEAR( m.sf(x[i]), r[i], 1e-14 );}
+}
+
+TEST( Mixture_Distribution_Tests, log_and_survival ) {
+    disMixture m;
+    m.insert(disNormal(0,1), 0.25);
+    m.insert(disNormal(3,1), 0.75);
+
+    EXPECT_DOUBLE_EQ( std::log(m.pdf(1.2)), m.logpdf(1.2) );
+    EXPECT_DOUBLE_EQ( 0.25*disNormal(0,1).sf(1.2) + 0.75*disNormal(3,1).sf(1.2), m.sf(1.2) );
+
+    // Far from both components pdf underflows, but the log-sum-exp does not.
+    const double expected = std::log(0.75) + disNormal(3,1).logpdf(60.)
+                          + std::log1p(std::exp(std::log(0.25/0.75) + disNormal(0,1).logpdf(60.) - disNormal(3,1).logpdf(60.)));
+    EXPECT_EQ( 0, m.pdf(60.) );
+    EXPECT_DOUBLE_EQ( expected, m.logpdf(60.) );
+    EXPECT_DOUBLE_EQ( std::log(0.75) + disNormal(3,1).logsf(60.), m.logsf(60.) );
+}
+
+TEST( Mixture_Distribution_Tests, sample_picks_by_weight ) {
+    // Components on disjoint supports; counts within 5 standard errors.
+    disMixture m;
+    m.insert(disUniform(0, 1), 0.2);
+    m.insert(disUniform(1, 2), 0.3);
+    m.insert(disUniform(2, 3), 0.5);
+    constexpr std::size_t n = 60000;
+    std::mt19937_64 eng(8);
+
+    auto check = [&](const std::vector<double>& x){
+        std::size_t c[3] = {0, 0, 0};
+        for (const double v : x) {c[std::min(2, int(v))]++;}
+        const double w[3] = {0.2, 0.3, 0.5};
+        for (int i=0; i<3; i++) {
+            const double p = w[i];
+            EXPECT_NEAR( p, double(c[i])/n, 5*std::sqrt(p*(1-p)/n) );
+        }
+    };
+    std::vector<double> x(n);
+    m.sample(eng, x);
+    check(x);
+    for (auto& v : x) {v = m.sample(eng);}
+    check(x);
+
+    disMixture empty;
+    EXPECT_THROW( empty.sample(eng), std::runtime_error );
+}
+
+TEST( Mixture_Distribution_Tests, reduce_preserves_moments ) {
+    disMixture m;
+    std::mt19937_64 eng(5);
+    std::normal_distribution<double> mu(0, 3);
+    std::uniform_real_distribution<double> v(0.1, 2), w(0.1, 1);
+    for (int i=0; i<300; i++) {m.insert(disNormal(mu(eng), v(eng)), w(eng));}
+    m.insert(disUniform(-1, 1), 0.5);
+    const double mean = m.mean(), var = m.variance();
+
+    const double cost = m.reduce(12);
+    EXPECT_GT( cost, 0 );
+    EXPECT_EQ( 12u, m.get().size() );
+    EXPECT_NEAR( mean, m.mean(), 1e-12 );
+    EXPECT_NEAR( var, m.variance(), 1e-11 );
+    EXPECT_TRUE( m.find(disUniform(-1, 1)) != m.end() );
+
+    double sum = 0;
+    for (const auto& [d,ws] : m.get()) {sum += ws.second;}
+    EXPECT_NEAR( 1, sum, 1e-14 );
+
+    // Nothing left to do.
+    EXPECT_EQ( 0, m.reduce(12) );
+    EXPECT_EQ( 0, m.reduce(100) );
+}
+
+TEST( Mixture_Distribution_Tests, reduce_cheapest_first ) {
+    /* N(0,1) and N(0.1,1) are closer than either is to N(5,1). */
+
+    disMixture m;
+    m.insert(disNormal(0, 1), 1);
+    m.insert(disNormal(0.1, 1), 1);
+    m.insert(disNormal(5, 1), 2);
+    const double cost = m.reduce(2);
+    ASSERT_EQ( 2u, m.get().size() );
+    EXPECT_TRUE( m.find(disNormal(5, 1)) != m.end() );
+    for (const auto& [d,ws] : m.get()) {
+        EXPECT_DOUBLE_EQ( 0.5, ws.second );
+        if (d->mean() == 5) continue;
+        EXPECT_DOUBLE_EQ( 0.05, d->mean() );
+        EXPECT_DOUBLE_EQ( 1.0025, d->variance() );
+    }
+    EXPECT_NEAR( 0.5*0.5*std::log(1.0025), cost, 1e-15 );
+
+    // A cost bound stops before the expensive merge.
+    EXPECT_EQ( 0, m.reduce(1, 0.1) );
+    EXPECT_EQ( 2u, m.get().size() );
+    EXPECT_GT( m.reduce(1), 0.1 );
+    EXPECT_EQ( 1u, m.get().size() );
+
+    // Equal components merge at no cost.
+    disMixture e;
+    for (int i=0; i<5; i++) {e.insert(disNormal(1, 2), 1);}
+    EXPECT_NEAR( 0, e.reduce(1, 1e-12), 1e-15 );
+    ASSERT_EQ( 1u, e.get().size() );
+    EXPECT_DOUBLE_EQ( 1, e.get().begin()->first->mean() );
+    EXPECT_DOUBLE_EQ( 2, e.get().begin()->first->variance() );
+}
+
+}
@@ -35,4 +35,11 @@ TEST( Noncentral_Chi_Distribution, cdf ) {
     EXPECT_DOUBLE_EQ(0.1132792455976077429640956095105139916, d1.cdf(2) );
 }
 
+TEST( Noncentral_Chi_Distribution, logpdf_large_argument ) {
+    // I_{1/2}(900) overflows a double; reference in 40-digit arithmetic.
+    disNcChi d(3,30);
+
+    EXPECT_NEAR( -0.91893853320467274178, d.logpdf(30), 1e-13 );
+}
+
 }
\ No newline at end of file
@@ -15,6 +15,7 @@
 */
 #include "gtest/gtest.h"
 #include "density/disNcChiSq.h"
+#include <vector>
 
 
 namespace statanaly {
@@ -35,4 +36,32 @@ TEST( Noncentral_Chi_Sq_Distribution, cdf ) {
     EXPECT_DOUBLE_EQ(0.2522069424260390183594385903034531831, d1.cdf(2) );
 }
 
+
+TEST( Noncentral_Chi_Sq_Distribution, cdf_left_tail ) {
+    // 1 - Q would round to 0 here.
+    disNcChiSq d1(2,3);
+
+    EXPECT_NEAR( 2.231301601484298289338383e-21, d1.cdf(2e-20), 1e-14*2.23e-21 );
+    EXPECT_EQ( 0., d1.cdf(-1) );
+    EXPECT_EQ( 1., d1.sf(0) );
+}
+
+TEST( Noncentral_Chi_Sq_Distribution, batch_cdf_matches_scalar ) {
+    disNcChiSq d1(3,7.5);
+    std::vector<double> x, r(400);
+    for (int i=0; i<400; ++i) {x.push_back(0.1*i - 1);}
+
+    d1.cdf(x, r);
+    for (int i=0; i<400; ++i) {EXPECT_EQ( d1.cdf(x[i]), r[i] );}
+    d1.sf(x, r);
+    for (int i=0; i<400; ++i) {EXPECT_EQ( d1.sf(x[i]), r[i] );}
+}
+
+TEST( Noncentral_Chi_Sq_Distribution, logpdf_large_argument ) {
+    // I_{1/2}(900) overflows a double; reference in 40-digit arithmetic.
+    disNcChiSq d(3,900);
+
+    EXPECT_NEAR( -5.0132830954267734266, d.logpdf(900), 1e-13 );
+}
+
 }
\ No newline at end of file
@@ -29,6 +29,32 @@ TEST( Normal_Distribution_Tests, cdf ) {
     EXPECT_DOUBLE_EQ(0.97724986805182079 , myNorm.cdf(-1.));
 };
 
+TEST( Normal_Distribution_Tests, log_and_survival ) {
+    auto myNorm = disNormal(0., 1.);
+    EXPECT_DOUBLE_EQ(std::log(myNorm.pdf(1.3)), myNorm.logpdf(1.3));
+    EXPECT_NEAR(7.61985302416052603958e-24, myNorm.sf(10.), 1e-13*7.62e-24);
+
+    // Far tails, where cdf(x) underflows.
+    EXPECT_DOUBLE_EQ(-8.04608442013753788202e+02, myNorm.logcdf(-40.));
+    EXPECT_DOUBLE_EQ(-8.04608442013753788202e+02, myNorm.logsf(40.));
+    EXPECT_DOUBLE_EQ(-800.918938533204672742, myNorm.logpdf(40.));
+};
+
+TEST( Normal_Distribution_Tests, quantile ) {
+    auto myNorm = disNormal(0., 1.);
+    EXPECT_DOUBLE_EQ(1.959963984540054, myNorm.quantile(0.975));
+    EXPECT_DOUBLE_EQ(-1.959963984540054, myNorm.quantile(0.025));
+    EXPECT_DOUBLE_EQ(0, myNorm.quantile(0.5));
+    EXPECT_EQ(-INFINITY, myNorm.quantile(0.));
+    EXPECT_EQ(INFINITY, myNorm.quantile(1.));
+
+    // Deep lower tail, checked through the log-cdf.
+    EXPECT_NEAR(std::log(1e-300), myNorm.logcdf(myNorm.quantile(1e-300)), 1e-12);
+
+    auto myNorm2 = disNormal(-2., 0.25);
+    EXPECT_DOUBLE_EQ(-1., myNorm2.quantile(myNorm2.cdf(-1.)));
+};
+
 TEST( Normal_Distribution_Tests, hash ) {
     disNormal d1(3, 8);
     disNormal d2(3, 8);
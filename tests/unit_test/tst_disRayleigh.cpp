@@ -29,6 +29,24 @@ TEST( Rayleigh_Distribution, cdf ) {
     disRayleigh d1(4);
 
     EXPECT_DOUBLE_EQ(0.9560630663765925826733, d1.cdf(10) );
+    // 1 - exp(-x^2/32) ~ x^2/32 would cancel.
+    EXPECT_DOUBLE_EQ(1e-12/32 * (1 - 1e-12/64), d1.cdf(1e-6) );
+}
+
+TEST( Rayleigh_Distribution, below_support ) {
+    disRayleigh d1(4);
+
+    EXPECT_EQ(0., d1.cdf(-1.));
+    EXPECT_EQ(1., d1.sf(-1.));
+    EXPECT_EQ(0., d1.logsf(-1.));
+    EXPECT_EQ(-INFINITY, d1.logcdf(-1.));
+
+    const std::vector<double> x{-1., 1e-6, 2., 10.};
+    std::vector<double> r(x.size());
+    d1.cdf(x, r);
+    for (std::size_t i=0; i<x.size(); ++i) {EXPECT_EQ(d1.cdf(x[i]), r[i]);}
+    d1.sf(x, r);
+    EXPECT_EQ(1., r[0]);
 }
 
 
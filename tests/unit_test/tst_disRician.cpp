@@ -33,5 +33,11 @@ TEST( Rician_Distribution, cdf ) {
     EXPECT_FLOAT_EQ(0.512532223392871104629, d1.cdf(4) );
 }
 
+TEST( Rician_Distribution, logpdf_large_argument ) {
+    // I0(900) overflows a double; reference in 40-digit arithmetic.
+    disRician d(30,1);
+
+    EXPECT_NEAR( -0.91879956706582874541, d.logpdf(30), 1e-13 );
+}
 
 }
\ No newline at end of file
@@ -0,0 +1,78 @@
+/*
+   Copyright 2022, Ansel Blumers
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "gtest/gtest.h"
+#include "density/disTabulated.h"
+#include "density/disNcChiSq.h"
+#include "density/disNormal.h"
+#include <vector>
+
+
+namespace statanaly {
+
+TEST( Tabulated_Distribution, matches_exact_within_tolerance ) {
+    const disNcChiSq exact(3,2);
+    const disTabulated d(exact, 0, 30, 1e-10);
+
+    EXPECT_LE( d.maxErrorPdf(), 1e-10 );
+    EXPECT_LE( d.maxErrorCdf(), 1e-10 );
+    EXPECT_LT( d.panels(), disTabulated::maxPanels );
+
+    for (double x = 0; x <= 30; x += 0.0173) {
+        EXPECT_NEAR( exact.pdf(x), d.pdf(x), 1e-9 ) << "x = " << x;
+        EXPECT_NEAR( exact.cdf(x), d.cdf(x), 1e-9 ) << "x = " << x;
+    }
+    EXPECT_NEAR( exact.cdf(30), d.cdf(30), 1e-9 );
+
+    std::vector<double> x, r(500);
+    for (int i=0; i<500; ++i) {x.push_back(0.06*i);}
+    d.cdf(x, r);
+    for (int i=0; i<500; ++i) {EXPECT_EQ( d.cdf(x[i]), r[i] );}
+}
+
+TEST( Tabulated_Distribution, exact_outside_range ) {
+    const disNormal exact(1,2);
+    const disTabulated d(exact, -3, 5);
+
+    EXPECT_EQ( exact.pdf(-3.5), d.pdf(-3.5) );
+    EXPECT_EQ( exact.cdf(7), d.cdf(7) );
+    EXPECT_NEAR( exact.cdf(0.3), d.cdf(0.3), 1e-12 );
+    EXPECT_EQ( exact.mean(), d.mean() );
+    EXPECT_EQ( exact.variance(), d.variance() );
+}
+
+TEST( Tabulated_Distribution, copy_and_hash ) {
+    const disNormal exact(0,1);
+    const disTabulated d(exact, -6, 6, 1e-8);
+
+    const disTabulated c(d);
+    const auto u = d.cloneUnique();
+    EXPECT_EQ( d.cdf(0.7), c.cdf(0.7) );
+    EXPECT_EQ( d.cdf(0.7), u->cdf(0.7) );
+    EXPECT_EQ( u->getID(), dFuncID::TABULATED_DISTR );
+    EXPECT_TRUE( d.isEqual_ulp(*u, 1) );
+    EXPECT_EQ( d.hash(), c.hash() );
+    EXPECT_NE( d.hash(), exact.hash() );
+    EXPECT_NE( d.hash(), disTabulated(exact, -6, 7, 1e-8).hash() );
+}
+
+TEST( Tabulated_Distribution, invalid_arguments ) {
+    const disNormal exact(0,1);
+    EXPECT_THROW( disTabulated(exact, 1, 1), std::invalid_argument );
+    EXPECT_THROW( disTabulated(exact, 2, 1), std::invalid_argument );
+    EXPECT_THROW( disTabulated(exact, 0, 1, 0.), std::invalid_argument );
+}
+
+}
@@ -0,0 +1,181 @@
+/*
+   Copyright 2022, Ansel Blumers
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "gtest/gtest.h"
+#include "distrArena.h"
+#include "dConvolution.h"
+#include "density/disMixture.h"
+#include <memory_resource>
+#include <vector>
+
+
+namespace statanaly {
+
+/** new_delete_resource() that counts the bytes out. */
+class countingResource : public std::pmr::memory_resource {
+public:
+    std::size_t out = 0;
+    std::size_t calls = 0;
+
+private:
+    void* do_allocate(std::size_t n, std::size_t a) override {
+        out += n;
+        ++calls;
+        return std::pmr::new_delete_resource()->allocate(n, a);
+    }
+    void do_deallocate(void* p, std::size_t n, std::size_t a) override {
+        out -= n;
+        std::pmr::new_delete_resource()->deallocate(p, n, a);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& o) const noexcept override {
+        return this == &o;
+    }
+};
+
+TEST( distrArena, clone_into_resource ) {
+    countingResource mr;
+    const disGamma g(2., 3.);
+    {
+        pmrPtr c = g.clone(&mr);
+        EXPECT_EQ( sizeof(disGamma), mr.out );
+        EXPECT_TRUE( c->isEqual_ulp(g, 0) );
+        EXPECT_DOUBLE_EQ( g.cdf(4), c->cdf(4) );
+    }
+    EXPECT_EQ( 0u, mr.out );
+
+    // A mixture's components follow it into the resource.
+    disMixture m;
+    m.insert(disNormal(0,1), 1);
+    m.insert(disUniform(0,2), 3);
+    {
+        pmrPtr c = m.clone(&mr);
+        const auto& cm = dynamic_cast<const disMixture&>(*c);
+        EXPECT_EQ( &mr, cm.get_allocator().resource() );
+        EXPECT_TRUE( cm.hash() == m.hash() );
+        EXPECT_GT( mr.out, sizeof(disMixture) + sizeof(disNormal) + sizeof(disUniform) );
+    }
+    EXPECT_EQ( 0u, mr.out );
+}
+
+TEST( distrArena, container_in_resource ) {
+    countingResource mr, other;
+    std::vector<std::pair<disNormal,double>> comps;
+    for (int i = 0; i < 100; ++i) {comps.emplace_back(disNormal(i, 1), 1);}
+    {
+        dCtr c(comps, false, &mr);
+        const std::size_t out = mr.out;
+        EXPECT_GE( out, 100*sizeof(disNormal) );
+
+        // Copies go to the default resource, or the one given.
+        dCtr d(c);
+        dCtr e(c, &other);
+        EXPECT_EQ( out, mr.out );
+        EXPECT_EQ( out, other.out );
+        EXPECT_EQ( c.hash(), e.hash() );
+
+        // Moving between resources copies.
+        d = std::move(e);
+        EXPECT_EQ( c.hash(), d.hash() );
+        e = std::move(c);
+        EXPECT_EQ( &other, e.get_allocator().resource() );
+        EXPECT_EQ( d.hash(), e.hash() );
+        EXPECT_TRUE( e.find(disNormal(42, 1)) != e.end() );
+    }
+    EXPECT_EQ( 0u, mr.out );
+    EXPECT_EQ( 0u, other.out );
+}
+
+TEST( distrArena, mixture_moves_with_its_resource ) {
+    countingResource mr;
+    {
+        disMixture m(&mr);
+        m.insert(disNormal(0,1), 1);
+        m.insert(disUniform(0,2), 3);
+        const std::size_t out = mr.out, calls = mr.calls;
+        const std::size_t h = m.hash();
+
+        // No copy on move: nothing new is allocated, anywhere.
+        disMixture n(std::move(m));
+        EXPECT_EQ( &mr, n.get_allocator().resource() );
+        EXPECT_EQ( calls, mr.calls );
+        EXPECT_EQ( h, n.hash() );
+
+        disMixture o(&mr);
+        o = std::move(n);
+        EXPECT_EQ( calls, mr.calls );
+        EXPECT_EQ( h, o.hash() );
+        EXPECT_EQ( out, mr.out );
+
+        // Into another resource, a move copies.
+        disMixture p;
+        p = std::move(o);
+        EXPECT_EQ( std::pmr::get_default_resource(), p.get_allocator().resource() );
+        EXPECT_EQ( h, p.hash() );
+    }
+    EXPECT_EQ( 0u, mr.out );
+}
+
+TEST( distrArena, convolution_results ) {
+    countingResource up;
+    disNormal a(1, 2), b(3, 4);
+    disGamma g(2., 1.), h(2., 1.);
+    {
+        distrArena arena(1024, &up);
+        std::vector<probDistr*> rs;
+        {
+            arenaScope scope(arena);
+            for (int i = 0; i < 1000; ++i) {
+                rs.push_back(cnvl.go(a, b));
+                rs.push_back(convolve(g, h));
+            }
+            rs.push_back(convolveMC(a, g, {1<<10, 1, 1}));
+
+            // Scopes nest.
+            distrArena inner;
+            {
+                arenaScope nested(inner);
+                cnvl.go(a, b);
+            }
+            EXPECT_EQ( 1u, inner.size() );
+            cnvl.go(a, b);
+        }
+        EXPECT_EQ( 2002u, arena.size() );
+        EXPECT_EQ( dFuncID::NORMAL_DISTR, rs[0]->getID() );
+        EXPECT_DOUBLE_EQ( 4, rs[0]->mean() );
+        EXPECT_EQ( dFuncID::EMPIRICAL_DISTR, rs.back()->getID() );
+
+        // Far fewer upstream allocations than results.
+        EXPECT_LT( up.calls, 20u );
+        EXPECT_GT( up.out, 0u );
+
+        arena.release();
+        EXPECT_EQ( 0u, arena.size() );
+        EXPECT_EQ( 0u, up.out );
+
+        // The arena, its list of results included, is reusable after release().
+        for (int i = 0; i < 100; ++i) {arena.make<disNormal>(i, 1.);}
+        EXPECT_EQ( 100u, arena.size() );
+        EXPECT_GT( up.out, 100*sizeof(disNormal) );
+        arena.release();
+        EXPECT_EQ( 0u, up.out );
+
+        // Out of scope: by new again.
+        probDistr* r = cnvl.go(a, b);
+        EXPECT_EQ( 0u, arena.size() );
+        delete r;
+    }
+}
+
+}
@@ -0,0 +1,79 @@
+/*
+   Copyright 2022, Ansel Blumers
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "gtest/gtest.h"
+#include "parallelSampler.h"
+#include "rand_num_gen.h"
+#include "density/disNormal.h"
+#include "density/disNcChiSq.h"
+#include "density/disExponential.h"
+#include "density/disMixture.h"
+#include <vector>
+
+
+namespace statanaly {
+
+TEST( parallelSampler, independent_of_thread_count ) {
+    /* A slow distribution among fast ones, buffers of uneven sizes. */
+
+    const disNcChiSq slow(3, 2.5);
+    const disNormal fast(1, 2);
+    const disExponential exp(0.5);
+    const std::size_t size[4] = {3*parallelSampler::chunkSize + 17, 5*parallelSampler::chunkSize, 0, 100};
+
+    std::vector<std::vector<double>> ref;
+    for (const unsigned T : {1u, 2u, 5u}) {
+        std::vector<std::vector<double>> out;
+        for (const std::size_t n : size) {out.emplace_back(n);}
+        const sampleJob jobs[4] = {{&slow, out[0]}, {&fast, out[1]}, {&exp, out[2]}, {&fast, out[3]}};
+
+        parallelSampler ps(T);
+        EXPECT_EQ( ps.threads(), T );
+        ps.run(jobs, 42);
+        if (ref.empty()) ref = out;
+        else EXPECT_EQ( out, ref ) << T << " threads";
+    }
+
+    // Chunk c of job j comes from stream j<<32 | c.
+    std::vector<double> c(17);
+    rng_philox eng(42, std::uint64_t(0) << 32 | 3);
+    slow.sample(eng, c);
+    EXPECT_TRUE( std::equal(c.begin(), c.end(), ref[0].begin() + 3*parallelSampler::chunkSize) );
+
+    rng_philox eng2(42, std::uint64_t(3) << 32);
+    std::vector<double> d(100);
+    fast.sample(eng2, d);
+    EXPECT_EQ( d, ref[3] );
+}
+
+TEST( parallelSampler, reuse_and_errors ) {
+    parallelSampler ps(3);
+    const disNormal n(0, 1);
+    std::vector<double> a(70000), b(70000);
+    ps.run(n, a, 7);
+    ps.run(n, b, 7);
+    EXPECT_EQ( a, b );
+    ps.run(n, b, 8);
+    EXPECT_NE( a, b );
+
+    // A draw that throws stops the run; the sampler stays usable.
+    const disMixture empty;
+    const sampleJob jobs[2] = {{&n, a}, {&empty, b}};
+    EXPECT_THROW( ps.run(jobs, 7), std::runtime_error );
+    ps.run(n, b, 7);
+    EXPECT_EQ( a, b );
+}
+
+}
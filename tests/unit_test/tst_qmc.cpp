@@ -0,0 +1,108 @@
+/*
+   Copyright 2022, Ansel Blumers
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "gtest/gtest.h"
+#include "qmc.h"
+#include "density/disNormal.h"
+#include "density/disGamma.h"
+#include <vector>
+
+
+namespace statanaly {
+
+TEST( sobol, first_points ) {
+    sobol s(2);
+    const double h = 0x1.0p-33;
+    const double expe[4][2] = {{0,0}, {0.5,0.5}, {0.75,0.25}, {0.25,0.75}};
+    double u[2];
+    for (auto& e : expe) {
+        s.next(u);
+        EXPECT_EQ( u[0], e[0]+h );
+        EXPECT_EQ( u[1], e[1]+h );
+    }
+    EXPECT_EQ( s.index(), 4u );
+}
+
+TEST( sobol, stratified ) {
+    /* The first 2^m points hit every interval [k/2^m, (k+1)/2^m) of every
+       dimension once, and every elementary box of the first two dimensions. */
+
+    constexpr unsigned m = 10, N = 1u<<m, D = sobol::maxDim;
+    for (int scrambled = 0; scrambled < 2; ++scrambled) {
+        sobol s = scrambled ? sobol(D, 3, 1) : sobol(D);
+        std::vector<double> u(N*D);
+        s.next(N, u);
+
+        for (unsigned j = 0; j < D; ++j) {
+            std::vector<int> hit(N);
+            for (unsigned i = 0; i < N; ++i) {
+                ASSERT_GT( u[j*N+i], 0 );
+                ASSERT_LT( u[j*N+i], 1 );
+                ++hit[unsigned(u[j*N+i]*N)];
+            }
+            EXPECT_EQ( std::count(hit.begin(), hit.end(), 1), N ) << "dimension " << j;
+        }
+
+        for (unsigned a = 0; a <= m; ++a) {
+            std::vector<int> hit(N);
+            for (unsigned i = 0; i < N; ++i) {
+                ++hit[unsigned(u[i]*(1u<<a)) << (m-a) | unsigned(u[N+i]*(1u<<(m-a)))];
+            }
+            EXPECT_EQ( std::count(hit.begin(), hit.end(), 1), N ) << "boxes 2^-" << a;
+        }
+    }
+}
+
+TEST( sobol, seek_and_streams ) {
+    sobol s(5, 9), t(5, 9);
+    std::vector<double> u(5), w(5);
+    for (int i = 0; i < 38; ++i) {s.next(u);}
+    t.seek(37);
+    t.next(w);
+    EXPECT_EQ( u, w );
+
+    sobol a(5, 9, 0), b(5, 9, 1);
+    a.next(u);
+    b.next(w);
+    EXPECT_NE( u, w );
+
+    EXPECT_THROW( sobol(0), std::invalid_argument );
+    EXPECT_THROW( sobol(sobol::maxDim+1), std::invalid_argument );
+}
+
+TEST( qmc, expectation_of_sum ) {
+    /* X + Y ~ N(0, 2), so E[exp(-(X+Y)^2)] = 1/sqrt(5). */
+
+    const disNormal n{0,1};
+    const qmcOptions opt{1<<12, 8};
+    const qmcEstimate e = qmcExpectSum({&n, &n}, [](const double s){ return std::exp(-s*s); }, opt);
+    EXPECT_NEAR( e.value, 1/std::sqrt(5.), 6*e.stdError );
+    EXPECT_NEAR( e.value, 1/std::sqrt(5.), 2e-4 );
+
+    /* E[N(1,4) + Gamma(3,2)] = 7; plain Monte Carlo with as many points has
+       a standard error of sqrt(22/2^15) ~ 2.6e-2. */
+    const disNormal a{1,4};
+    const disGamma b{3.,2.};
+    const qmcEstimate m = qmcExpectSum({&a, &b}, [](const double s){ return s; }, opt);
+    EXPECT_NEAR( m.value, 7, 6*m.stdError );
+    EXPECT_LT( m.stdError, 2.6e-3 );
+
+    const qmcEstimate r = qmcExpectSum({&a, &b}, [](const double s){ return s; }, opt);
+    EXPECT_EQ( m.value, r.value );
+
+    EXPECT_THROW( qmcExpectSum({&a, &b}, [](const double s){ return s; }, {1024, 1}), std::invalid_argument );
+}
+
+}
@@ -0,0 +1,146 @@
+/*
+   Copyright 2022, Ansel Blumers
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "gtest/gtest.h"
+#include "density/sampling.h"
+#include <cmath>
+#include <random>
+#include <vector>
+
+
+namespace statanaly {
+
+TEST( rngRef, full_range_words ) {
+    // A 64-bit engine is passed through; a 32-bit one is called twice per word.
+    std::mt19937_64 e64(1), c64(1);
+    rngRef r64(e64);
+    EXPECT_EQ( c64(), r64() );
+
+    std::mt19937 e32(1), c32(1);
+    rngRef r32(e32);
+    const std::uint64_t hi = c32();
+    EXPECT_EQ( (hi << 32) | c32(), r32() );
+
+    // Other ranges still cover all 64 bits.
+    std::minstd_rand e(3);
+    rngRef r(e);
+    std::uint64_t any = 0;
+    for (int i=0; i<64; ++i) {any |= r();}
+    EXPECT_EQ( UINT64_MAX, any );
+}
+
+TEST( rngRef, fill_matches_calls ) {
+    std::mt19937_64 e1(5), e2(5);
+    rngRef r1(e1), r2(e2);
+    std::vector<std::uint64_t> w(300);
+    r1.fill(w);
+    for (const auto v : w) {EXPECT_EQ( r2(), v );}
+}
+
+TEST( Sampling_Helpers, unit_intervals ) {
+    EXPECT_EQ( 0., toUnit(0) );
+    EXPECT_LT( toUnit(UINT64_MAX), 1. );
+    EXPECT_GT( toOpenUnit(0), 0. );
+    EXPECT_LT( toOpenUnit(UINT64_MAX), 1. );
+}
+
+TEST( Sampling_Helpers, ziggurat_tails ) {
+    // Tail masses beyond the base layers, and within 5 standard errors.
+    constexpr std::size_t n = 400000;
+    std::mt19937_64 eng(3);
+    rngRef rng(eng);
+    std::vector<double> x(n);
+
+    auto frac = [&](auto pred){
+        std::size_t c = 0;
+        for (const double a : x) {c += pred(a);}
+        return double(c)/n;
+    };
+    auto check = [&](const double p, const double got){
+        EXPECT_NEAR( p, got, 5*std::sqrt(p*(1-p)/n) );
+    };
+
+    // P(|Z| > 3.654) = 2.580e-4, P(Z < -1) = 0.15866
+    stdNormal(rng, x);
+    check(2.5803e-4, frac([](double a){ return std::abs(a) > 3.6541528853610088; }));
+    check(0.158655, frac([](double a){ return a < -1; }));
+    for (auto& a : x) {a = stdNormal(rng);}
+    check(2.5803e-4, frac([](double a){ return std::abs(a) > 3.6541528853610088; }));
+
+    // P(E > 7.697) = 4.541e-4, P(E < 0.5) = 0.39347
+    stdExponential(rng, x);
+    check(4.5413e-4, frac([](double a){ return a > 7.69711747013104972; }));
+    check(0.393469, frac([](double a){ return a < 0.5; }));
+    for (auto& a : x) {a = stdExponential(rng);}
+    check(4.5413e-4, frac([](double a){ return a > 7.69711747013104972; }));
+}
+
+TEST( Sampling_Helpers, moments ) {
+    // Sample means and variances within ~5 standard errors.
+    constexpr std::size_t n = 100000;
+    std::mt19937_64 eng(11);
+    rngRef rng(eng);
+    std::vector<double> x(n);
+
+    auto check = [&](const double mean, const double var){
+        double m = 0, v = 0;
+        for (const double a : x) {m += a;}
+        m /= n;
+        for (const double a : x) {v += (a-m)*(a-m);}
+        v /= n-1;
+        EXPECT_NEAR( mean, m, 5*std::sqrt(var/n) );
+        EXPECT_NEAR( var, v, 0.05*var );
+    };
+
+    stdNormal(rng, x);
+    check(0, 1);
+    for (auto& a : x) {a = stdNormal(rng);}
+    check(0, 1);
+
+    stdExponential(rng, x);
+    check(1, 1);
+    for (auto& a : x) {a = stdExponential(rng);}
+    check(1, 1);
+
+    stdGamma(rng, 0.4, x);
+    check(0.4, 0.4);
+    for (auto& a : x) {a = stdGamma(rng, 0.4);}
+    check(0.4, 0.4);
+    stdGamma(rng, 7.5, x);
+    check(7.5, 7.5);
+    for (auto& a : x) {a = stdGamma(rng, 7.5);}
+    check(7.5, 7.5);
+    stdGamma(rng, 1e4, x);
+    check(1e4, 1e4);
+
+    stdErlang(rng, 3, x);
+    check(3, 3);
+    for (auto& a : x) {a = stdErlang(rng, 3);}
+    check(3, 3);
+    stdErlang(rng, 40, x);
+    check(40, 40);
+
+    stdChiSq(rng, 1, x);
+    check(1, 2);
+    stdChiSq(rng, 3, x);
+    check(3, 6);
+    stdChiSq(rng, 20, x);
+    check(20, 40);
+    for (auto& a : x) {a = stdPoisson(rng, 3.5);}
+    check(3.5, 3.5);
+    EXPECT_EQ( 0., stdPoisson(rng, 0.) );
+}
+
+}
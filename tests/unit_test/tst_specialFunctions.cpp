@@ -15,6 +15,7 @@
 */
 #include "gtest/gtest.h"
 #include "density/specialFunc.h"
+#include <vector>
 
 
 namespace statanaly {
@@ -50,6 +51,53 @@ TEST( Regularized_Upper_Gamma_Function, computation ) {
     EXPECT_DOUBLE_EQ( expected2, regUpperGamma(8,4) );
 }
 
+TEST( Regularized_Gamma_Function, large_shape ) {
+    // Reference: mpmath gammainc in 40-digit arithmetic.
+
+    EXPECT_NEAR( 0.3173568111697999998802068, regLowerGamma(100, 95), 1e-15 );
+    EXPECT_NEAR( 0.6826431888302000001197932, regUpperGamma(100, 95), 1e-15 );
+    EXPECT_NEAR( 0.1862819731903246006554908, regLowerGamma(500, 480), 1e-15 );
+    EXPECT_NEAR( 0.000549902265711782923013037, regLowerGamma(1000, 900), 1e-14*0.00055 );
+    EXPECT_NEAR( 0.001059323253929977348874933, regUpperGamma(1000, 1100), 1e-14*0.00106 );
+    EXPECT_NEAR( 0.9989406767460700226511251, regLowerGamma(1000, 1100), 1e-15 );
+}
+
+TEST( Regularized_Gamma_Function, non_positive_power ) {
+    EXPECT_EQ( 0., regLowerGamma(3.5, 0.) );
+    EXPECT_EQ( 1., regUpperGamma(3.5, 0.) );
+    EXPECT_EQ( 0., regLowerGamma(3.5, -2.) );
+    EXPECT_EQ( 1., regUpperGamma(3.5, -2.) );
+}
+
+TEST( Regularized_Gamma_Function, batch_matches_scalar ) {
+    std::vector<double> z, p(400), q(400);
+    for (int i=0; i<400; ++i) {z.push_back(0.25*i - 5);}
+
+    for (const double s : {0.5, 3.5, 40., 120.}) {
+        regLowerGamma(s, z, p);
+        regUpperGamma(s, z, q);
+        for (int i=0; i<400; ++i) {
+            EXPECT_EQ( regLowerGamma(s, z[i]), p[i] );
+            EXPECT_EQ( regUpperGamma(s, z[i]), q[i] );
+        }
+    }
+
+    std::vector<double> zz(z);
+    regLowerGamma(3.5, zz, zz);
+    for (int i=0; i<400; ++i) {EXPECT_EQ( regLowerGamma(3.5, z[i]), zz[i] );}
+    EXPECT_THROW( regLowerGamma(3.5, z, std::span<double>(p).first(10)), std::invalid_argument );
+}
+
+TEST( Log_Bessel_I_Function, beyond_overflow ) {
+    // Reference: 40-digit arithmetic.
+
+    EXPECT_NEAR( 895.68000305127201588, logBesselI(0, 900), 1e-12 );
+    EXPECT_NEAR( -1622.8491735494096397, logBesselI(300, 1), 1e-11 );
+    EXPECT_DOUBLE_EQ( std::log(std::cyl_bessel_i(2.5, 600.)), logBesselI(2.5, 600) );
+    EXPECT_DOUBLE_EQ( std::log(std::cyl_bessel_i(200., 600.)), logBesselI(200, 600) );
+    EXPECT_DOUBLE_EQ( std::log(std::cyl_bessel_i(1.5, 3.)), logBesselI(1.5, 3) );
+}
+
 TEST( MarcumQ_Function, integer_M ) {
     // https://www.wolframalpha.com/input/?i=ScientificForm%28marcumq%5B3%2C1.3%2C1.5%5D%29
 
@@ -64,5 +112,35 @@ TEST( MarcumQ_Function, non_integer_M ) {
     EXPECT_FLOAT_EQ( 0.692728870227774340018922937858990, marcumQ(1.4, 1.3, 1.5) );
 }
 
+TEST( MarcumQ_Function, tails_and_large_arguments ) {
+    // Reference: Poisson-gamma series in 40-digit arithmetic.
+
+    EXPECT_NEAR( 2.478220808362368882151074e-88, marcumQ(2.5, 10, 30), 1e-13*2.48e-88 );
+    EXPECT_NEAR( 4.104349223572477255298309e-198, marcumP(1, 100, 70), 1e-12*4.1e-198 );
+    EXPECT_NEAR( 7.106879782380098109550741e-24, marcumP(1.5, 150, 140), 1e-12*7.1e-24 );
+    EXPECT_NEAR( 0.5049871682341438313509967, marcumQ(1, 40, 40), 1e-13 );
+    EXPECT_NEAR( 0.4950128317658561686490033, marcumP(1, 40, 40), 1e-13 );
+
+    EXPECT_EQ( 1., marcumQ(2, 3, 0) );
+    EXPECT_EQ( 0., marcumP(2, 3, 0) );
+    EXPECT_DOUBLE_EQ( regUpperGamma(2.5, 2.), marcumQ(2.5, 0, 2) );
+    EXPECT_THROW( marcumQ(-1, 1, 1), std::invalid_argument );
+}
+
+TEST( MarcumQ_Function, batch_matches_scalar ) {
+    std::vector<double> b, q(300), p(300);
+    for (int i=0; i<300; ++i) {b.push_back(0.1*i);}
+
+    marcumQ(1.5, 7., b, q);
+    marcumP(1.5, 7., b, p);
+    for (int i=0; i<300; ++i) {
+        EXPECT_EQ( marcumQ(1.5, 7., b[i]), q[i] );
+        EXPECT_EQ( marcumP(1.5, 7., b[i]), p[i] );
+    }
+
+    marcumQ(1.5, 7., b, b);
+    for (int i=0; i<300; ++i) {EXPECT_EQ( q[i], b[i] );}
+}
+
 
 }
\ No newline at end of file
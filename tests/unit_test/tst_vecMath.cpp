@@ -0,0 +1,164 @@
+/*
+   Copyright 2022, Ansel Blumers
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "gtest/gtest.h"
+#include "density/vecMath.h"
+#include <cmath>
+#include <limits>
+#include <vector>
+
+
+namespace statanaly {
+
+namespace {
+
+constexpr simdISA allISA[] = {simdISA::SCALAR, simdISA::SSE2, simdISA::AVX2, simdISA::AVX512};
+
+/** Relative error, counting NaN == NaN and equal infinities as exact. */
+double relErr(const double expected, const double actual) {
+    if (std::isnan(expected)) return std::isnan(actual) ? 0 : 1;
+    if (expected == actual) return 0;
+    return std::abs(actual-expected) / std::abs(expected);
+}
+
+/** Inputs of odd length, including special values, so the tail path is exercised. */
+std::vector<double> inputs(const double lo, const double hi) {
+    std::vector<double> x;
+    for (int i=0; i<=1000; ++i) {x.push_back(lo + (hi-lo)*i/1000);}
+    x.push_back(0.);
+    x.push_back(-0.);
+    x.push_back(std::numeric_limits<double>::infinity());
+    x.push_back(-std::numeric_limits<double>::infinity());
+    x.push_back(std::numeric_limits<double>::quiet_NaN());
+    x.push_back(std::numeric_limits<double>::denorm_min());
+    return x;
+}
+
+template<class Vec, class Ref>
+void checkAll(Vec vec, Ref ref, const std::vector<double>& x, const double tol) {
+    for (const simdISA isa : allISA) {
+        if (simdSelect(isa) != isa) continue;
+
+        std::vector<double> r(x.size());
+        vec(x, r);
+        for (std::size_t i=0; i<x.size(); ++i) {
+            EXPECT_LE(relErr(ref(x[i]), r[i]), tol) << "isa " << int(isa) << ", x = " << x[i];
+        }
+
+        // In place.
+        std::vector<double> y = x;
+        vec(y, y);
+        EXPECT_EQ(r.size(), y.size());
+        for (std::size_t i=0; i<x.size(); ++i) {
+            EXPECT_EQ(relErr(r[i], y[i]), 0);
+        }
+    }
+    simdSelect(simdSupported());
+}
+
+}   // namespace
+
+
+TEST( vecMath, dispatch ) {
+    EXPECT_EQ( simdSelect(simdISA::SCALAR), simdISA::SCALAR );
+    EXPECT_EQ( simdActive(), simdISA::SCALAR );
+    EXPECT_EQ( simdSelect(simdISA::AVX512), simdSupported() );
+    EXPECT_EQ( simdActive(), simdSupported() );
+}
+
+TEST( vecMath, exp ) {
+    checkAll([](const auto& x, auto& r){ vecExp(std::span<const double>(x), std::span<double>(r)); },
+        [](double v){ return std::exp(v); }, inputs(-745, 710), 1e-15);
+}
+
+TEST( vecMath, log ) {
+    checkAll([](const auto& x, auto& r){ vecLog(std::span<const double>(x), std::span<double>(r)); },
+        [](double v){ return std::log(v); }, inputs(-1, 1e3), 1e-15);
+    checkAll([](const auto& x, auto& r){ vecLog(std::span<const double>(x), std::span<double>(r)); },
+        [](double v){ return std::log(v); }, inputs(0.5, 2), 1e-15);
+}
+
+TEST( vecMath, erf ) {
+    checkAll([](const auto& x, auto& r){ vecErf(std::span<const double>(x), std::span<double>(r)); },
+        [](double v){ return std::erf(v); }, inputs(-7, 7), 1e-15);
+}
+
+TEST( vecMath, erfc ) {
+    checkAll([](const auto& x, auto& r){ vecErfc(std::span<const double>(x), std::span<double>(r)); },
+        [](double v){ return std::erfc(v); }, inputs(-6, 27), 1e-13);
+}
+
+TEST( vecMath, atan ) {
+    checkAll([](const auto& x, auto& r){ vecAtan(std::span<const double>(x), std::span<double>(r)); },
+        [](double v){ return std::atan(v); }, inputs(-50, 50), 1e-15);
+}
+
+TEST( vecMath, pow ) {
+    checkAll([](const auto& x, auto& r){ vecPow(std::span<const double>(x), 2.5, std::span<double>(r)); },
+        [](double v){ return std::pow(v, 2.5); }, inputs(-1, 1e3), 1e-15);
+
+    const std::vector<double> x = inputs(1e-3, 50);
+    std::vector<double> y(x.size()), r(x.size());
+    for (std::size_t i=0; i<y.size(); ++i) {y[i] = -20. + 0.04*i;}
+    for (const simdISA isa : allISA) {
+        if (simdSelect(isa) != isa) continue;
+        vecPow(x, y, r);
+        for (std::size_t i=0; i<x.size(); ++i) {
+            EXPECT_LE(relErr(std::pow(x[i], y[i]), r[i]), 1e-14) << "isa " << int(isa) << ", x = " << x[i];
+        }
+    }
+    simdSelect(simdSupported());
+}
+
+TEST( vecMath, philox ) {
+    // Random123 kat_vectors for philox4x32_10; the counter is (first, stream).
+    struct kat { std::uint64_t key, stream, first, w0, w1; };
+    const kat kats[] = {
+        {0, 0, 0, 0xe169c58d6627e8d5ull, 0x9b00dbd8bc57ac4cull},
+        {~0ull, ~0ull, ~0ull, 0x41c83b0e408f276dull, 0x6d5451fda20bc7c6ull},
+        {0x299f31d0a4093822ull, 0x0370734413198a2eull, 0x85a308d3243f6a88ull,
+         0x94fdccebd16cfe09ull, 0x24126ea15001e420ull},
+    };
+    for (const simdISA isa : allISA) {
+        if (simdSelect(isa) != isa) continue;
+        for (const auto& t : kats) {
+            std::uint64_t w[2];
+            vecPhilox(t.key, t.stream, t.first, w);
+            EXPECT_EQ( t.w0, w[0] ) << "isa " << int(isa);
+            EXPECT_EQ( t.w1, w[1] ) << "isa " << int(isa);
+        }
+        std::uint64_t odd[3];
+        EXPECT_THROW( vecPhilox(0, 0, 0, odd), std::invalid_argument );
+    }
+    simdSelect(simdSupported());
+}
+
+TEST( vecMath, float_overloads ) {
+    std::vector<float> x, r(600);
+    for (int i=0; i<600; ++i) {x.push_back(-3.f + 0.01f*i);}
+    vecExp(std::span<const float>(x), std::span<float>(r));
+    for (int i=0; i<600; ++i) {EXPECT_EQ( r[i], static_cast<float>(std::exp(double(x[i]))) );}
+    vecErfc(std::span<const float>(x), std::span<float>(r));
+    for (int i=0; i<600; ++i) {EXPECT_FLOAT_EQ( r[i], std::erfc(x[i]) );}
+}
+
+TEST( vecMath, rejects_short_output ) {
+    std::vector<double> x(10, 1.), r(9);
+    EXPECT_THROW( vecExp(std::span<const double>(x), std::span<double>(r)), std::invalid_argument );
+    EXPECT_THROW( vecPow(std::span<const double>(x), std::span<const double>(r), std::span<double>(x)),
+        std::invalid_argument );
+}
+
+}   // namespace statanaly